@@ -4,19 +4,29 @@
 #include <mpi.h>
 #include <openssl/des.h>
 #include <ctype.h>
+#include "../common/des_keys.h"
+#include "../common/des_bs.h"
+#include "../common/des_gray.h"
+#include "../common/des_prefix.h"
+#include "../common/des_verify.h"
+#include "../common/des_targets.h"
+#include "../common/des_sched.h"
+#include "../common/des_stop.h"
+#include "../common/des_poll.h"
 
 #define MAX_TEXT 4096
-#define CHECK_INTERVAL 10000  // Revisar si otro proceso encontró la clave cada N iteraciones
 
 // Buffer estático para evitar allocaciones repetidas (thread-local para MPI)
 static unsigned char temp_buffer[MAX_TEXT];
 
+// Núcleo de verificación para la longitud del mensaje y la palabra (des_verify_select)
+static des_verify_fn verify_kernel = des_verify_generic;
+
 void decrypt(long key, unsigned char *ciph, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -31,8 +41,7 @@ void encrypt(long key, unsigned char *plain, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -60,50 +69,195 @@ int isLikelyPlaintext(unsigned char *data, int len) {
     return (printable * 100 / check_len) > 90;
 }
 
-int tryKey(long key, unsigned char *ciph, int len, 
-                    unsigned char *temp_buffer, const char *search_word) {
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    unsigned char first_block[8];
+int tryKey(long key, unsigned char *ciph, int len,
+           unsigned char *temp_buffer, const des_crib_t *crib) {
+    des_sp_key ks;
     
-    // Setup key UNA SOLA VEZ
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
+    // Subclaves desde el índice canónico (tablas de des_sp.h, sin OpenSSL)
+    des_sp_set_key(&ks, key);
     
-    // Quick check del primer bloque
-    memcpy(first_block, ciph, 8);
-    DES_ecb_encrypt((DES_cblock *)first_block,
-                    (DES_cblock *)first_block,
-                    &schedule,
-                    DES_DECRYPT);
-    
-    if (!isLikelyPlaintext(first_block, 8)) {
-        return 0;  // Descarta sin descifrar todo
+    // Descifrado bloque a bloque: se descarta en el primer bloque que no es texto y la
+    // palabra se busca sobre la marcha (núcleo elegido al arrancar para ciphlen y la palabra)
+    return verify_kernel(&ks, ciph, len, crib, temp_buffer);
+}
+
+// Prueba `count` claves consecutivas desde base_key (hasta des_bs_lanes()) con el kernel
+// bitsliced y confirma con tryKey los carriles que pasan el filtro del primer bloque.
+// ks guarda el lote anterior para cargar de forma incremental los lotes en orden Gray.
+// Devuelve cuántas claves coincidieron y las deja en hits.
+int tryKeys(des_bs_keys *ks, long base_key, int count, unsigned char *ciph, int len,
+            unsigned char *temp_buffer, const des_crib_t *crib, long *hits) {
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+
+    uint64_t candidates[DES_BS_LANES / 64];
+    if (!des_bs_candidates(ks, count, ciph, candidates)) return 0;
+
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        while (candidates[w]) {
+            int lane = 64 * w + __builtin_ctzll(candidates[w]);
+            candidates[w] &= candidates[w] - 1;
+            if (tryKey(base_key + lane, ciph, len, temp_buffer, crib)) {
+                hits[num_hits++] = base_key + lane;
+            }
+        }
     }
-    
-    // Si pasa, descifrar el resto (reutilizando schedule)
-    memcpy(temp_buffer, ciph, len);
-    memcpy(temp_buffer, first_block, 8);  // Ya tenemos el primer bloque
-    
-    for (int i = 8; i < len; i += 8) {  // Empezar desde bloque 2
-        DES_ecb_encrypt((DES_cblock *)(temp_buffer + i),
-                        (DES_cblock *)(temp_buffer + i),
-                        &schedule,
-                        DES_DECRYPT);
+    return num_hits;
+}
+
+// Verificación completa de un acierto del modo texto conocido: el prefijo entero y, si se
+// dio con -s, la palabra de búsqueda
+int tryKeyPrefix(long key, unsigned char *ciph, int len, unsigned char *temp_buffer,
+                 const des_crib_t *crib, const des_prefix_t *prefix) {
+    des_sp_key ks;
+
+    des_sp_set_key(&ks, key);
+    des_sp_decrypt_all(&ks, ciph, len, temp_buffer);
+    return des_prefix_check(prefix, temp_buffer, len) && des_crib_search(crib, temp_buffer, len);
+}
+
+// Modo texto conocido (-p): cada clave cuesta descifrar el primer bloque y compararlo con
+// el prefijo; solo los aciertos se descifran enteros.
+int tryKeysPrefix(des_bs_keys *ks, long base_key, int count, unsigned char *ciph, int len,
+                  unsigned char *temp_buffer, const des_crib_t *crib,
+                  const des_prefix_t *prefix, long *hits) {
+    uint64_t matches[1][DES_BS_LANES / 64];
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+    if (!des_bs_match(ks, count, ciph, 0, &prefix->block, 1, prefix->care, matches)) return 0;
+
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        while (matches[0][w]) {
+            long key = base_key + 64 * w + __builtin_ctzll(matches[0][w]);
+            matches[0][w] &= matches[0][w] - 1;
+            if (tryKeyPrefix(key, ciph, len, temp_buffer, crib, prefix)) {
+                hits[num_hits++] = key;
+            }
+        }
+    }
+    return num_hits;
+}
+
+// Modo complemento (-c): E_~k(~P) = ~E_k(P). Con el bloque conocido P0 -> C0 y el bloque
+// elegido ~P0 -> C1, un solo cifrado E_k(P0) prueba k (si da C0) y ~k (si da ~C1), así que
+// basta recorrer la mitad del espacio. known = {P0, C0, ~C1}.
+int tryKeysComplement(des_bs_keys *ks, long base_key, int count, const unsigned char known[3][8],
+                      unsigned char *ciph, int len, unsigned char *temp_buffer,
+                      const des_crib_t *crib, long *hits) {
+    uint64_t matches[2][DES_BS_LANES / 64];
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+    if (!des_bs_match(ks, count, known[0], 1, known + 1, 2, NULL, matches)) return 0;
+
+    for (int t = 0; t < 2; t++) {
+        for (int w = 0; w < des_bs_lanes() / 64; w++) {
+            while (matches[t][w]) {
+                long key = base_key + 64 * w + __builtin_ctzll(matches[t][w]);
+                matches[t][w] &= matches[t][w] - 1;
+                if (t == 1) key = des_key_complement(key);
+                if (tryKey(key, ciph, len, temp_buffer, crib)) {
+                    hits[num_hits++] = key;
+                }
+            }
+        }
+    }
+    return num_hits;
+}
+
+// Modo multiobjetivo (-t): un solo barrido del espacio contra todos los objetivos
+// (des_targets.h). Cada acierto se anuncia al momento y se avisa al resto de procesos; la
+// búsqueda sigue hasta resolverlos todos o agotar el rango.
+void searchTargets(des_targets_t *targets, const des_prefix_t *prefix, const des_crib_t *crib,
+                   MPI_Comm comm) {
+    int N, id;
+    MPI_Comm_size(comm, &N);
+    MPI_Comm_rank(comm, &id);
+
+    uint64_t upper = DES_KEY_SPACE;
+    long range_per_node = upper / N;
+    long mylower = range_per_node * id;
+    long myupper = (id == N - 1) ? upper : range_per_node * (id + 1);
+
+    if (id == 0) {
+        printf("Rango de búsqueda total: %ld\n", upper);
+        printf("Kernel DES: %s (%d claves por lote)\n", des_bs_kernel_name, des_bs_lanes());
+        printf("Objetivos: %d%s\n", targets->n,
+               targets->filter == DES_TARGETS_PREFIX ? " (un bloque por clave para todos)" : "");
+        for (int t = 0; t < targets->n; t++) {
+            printf("  [%d] %s (%d bytes)\n", t, targets->name[t], targets->len[t]);
+        }
+        printf("Iniciando búsqueda...\n\n");
+    }
+
+    MPI_Barrier(comm);
+    double start_time = MPI_Wtime();
+
+    des_targets_open(targets, comm);
+
+    long keys_tested = 0;
+    int solved[DES_TARGETS_MAX];
+    des_poll_t poll;
+    unsigned char temp_buffer[MAX_TEXT + 8] __attribute__((aligned(64)));
+    static des_bs_keys batch_keys;
+    des_gray_t walk;
+    long key;
+    int count;
+
+    des_bs_keys_init(&batch_keys);
+    des_gray_init(&walk, mylower, myupper, des_bs_lanes());
+    des_poll_init(&poll, DES_POLL_LATENCY, 0, start_time);
+    while (targets->pending > 0 && des_gray_next(&walk, &key, &count)) {
+        keys_tested += count;
+
+        int num_solved = des_targets_scan(targets, &batch_keys, key, count, prefix, NULL, crib,
+                                          temp_buffer, solved);
+        for (int i = 0; i < num_solved; i++) {
+            int t = solved[i];
+            printf("Proceso %d resolvió el objetivo %d (%s): clave %ld (%.2f s)\n",
+                   id, t, targets->name[t], targets->key[t], MPI_Wtime() - start_time);
+            fflush(stdout);
+            des_targets_notify(targets, t);
+        }
+
+        // Cada DES_POLL_LATENCY segundos, aplicar los avisos de otros procesos
+        if (des_poll_due(&poll)) {
+            des_poll_begin(&poll);
+            des_targets_poll(targets);
+        }
+    }
+
+    double total_time = MPI_Wtime() - start_time;
+    des_targets_finish(targets);
+
+    long total_keys_tested;
+    MPI_Reduce(&keys_tested, &total_keys_tested, 1, MPI_LONG, MPI_SUM, 0, comm);
+
+    if (id == 0) {
+        printf("\nRESULTADOS \n");
+        for (int t = 0; t < targets->n; t++) {
+            if (targets->key[t] == -1) {
+                printf("[%d] %s: sin resolver\n", t, targets->name[t]);
+                continue;
+            }
+            printf("[%d] %s: clave %ld\n", t, targets->name[t], targets->key[t]);
+            memcpy(temp_buffer, targets->ciph[t], targets->len[t]);
+            decrypt(targets->key[t], temp_buffer, targets->len[t]);
+            temp_buffer[targets->len[t]] = 0;
+            printf("    %.60s\n", temp_buffer);
+        }
+        printf("Total de claves probadas: %ld\n", total_keys_tested);
+        printf("Tiempo total: %.2f segundos\n", total_time);
+        printf("Velocidad: %.0f claves/segundo\n", total_keys_tested / total_time);
     }
-    
-    temp_buffer[len] = 0;
-    return strstr((char *)temp_buffer, search_word) != NULL;
 }
 
 int main(int argc, char *argv[]) {
     int N, id;
-    MPI_Status st;
-    MPI_Request req;
     MPI_Comm comm = MPI_COMM_WORLD;
-    long found = 0;
-    int flag = 0;
+    long found = DES_STOP_NONE;
     double start_time, end_time;
 
     // Parámetros configurables
@@ -111,19 +265,34 @@ int main(int argc, char *argv[]) {
     char search_word[256] = "";
     char input_file[256] = "input.txt";
     
-    // Parámetros automáticos del sistema
-    int check_interval = CHECK_INTERVAL;
+    int complement = 0;
+    unsigned char known[3][8];   // P0, C0, ~C1 para el modo complemento
+    des_prefix_t prefix = {0};   // texto conocido (-p)
+    des_crib_t crib;             // palabra de búsqueda lista para la verificación incremental
+    des_targets_t targets;       // objetivos de -t (targets.n == 0 si no se usa)
+    const char *target_args[DES_TARGETS_MAX];
+    int num_target_args = 0;
+
+    des_targets_init(&targets);
 
     MPI_Init(&argc, &argv);
     MPI_Comm_size(comm, &N);
     MPI_Comm_rank(comm, &id);
 
+    des_bs_init();
+    des_bs_set_keymap(des_key_to_block);
+
     if (id == 0) {
+        if (!des_bs_selftest()) {
+            fprintf(stderr, "Error: el kernel DES bitsliced no coincide con OpenSSL\n");
+            MPI_Abort(comm, 1);
+        }
+
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) { // Llave de cifrado
                 known_key = atol(argv[++i]);
-                if (known_key <= 0) { // Validación de clave válida
-                    fprintf(stderr, "Error: La clave debe ser un número positivo\n");
+                if (known_key <= 0 || !des_key_valid(known_key)) { // Validación de clave válida
+                    fprintf(stderr, "Error: La clave debe estar entre 1 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(comm, 1);
                 }
             } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) { // Palabras clave a buscar en descifrado
@@ -134,29 +303,67 @@ int main(int argc, char *argv[]) {
                 }
             } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) { // Archivo con texto a cifrar (opcional)
                 strncpy(input_file, argv[++i], sizeof(input_file) - 1);
+            } else if (strcmp(argv[i], "-c") == 0) { // Modo complemento (bloque elegido ~P0)
+                complement = 1;
+            } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) { // Texto conocido (texto o 0xHEX)
+                if (!des_prefix_parse(&prefix, argv[++i])) {
+                    fprintf(stderr, "Error: prefijo inválido (texto o 0x seguido de hexadecimal)\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) { // Objetivo: archivo[:clave] o hex
+                if (num_target_args == DES_TARGETS_MAX) {
+                    fprintf(stderr, "Error: como máximo %d objetivos\n", DES_TARGETS_MAX);
+                    MPI_Abort(comm, 1);
+                }
+                target_args[num_target_args++] = argv[++i];
             }
         }
 
-        if (strlen(search_word) == 0) {// Validar presencia de parámetro
-            fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n\n");
+        if (prefix.len > 0 && complement) {
+            fprintf(stderr, "Error: -p y -c no se pueden combinar\n");
             MPI_Abort(comm, 1);
         }
 
-        // Ajustar check_interval basado en número de procesos
-        if (N >= 8) {
-            check_interval = 5000;  // Más frecuente con muchos procesos
-        } else if (N >= 4) {
-            check_interval = 10000;
-        } else {
-            check_interval = 20000;  // Menos frecuente con pocos procesos
+        if (num_target_args > 0 && complement) {
+            fprintf(stderr, "Error: -t no se puede combinar con -c\n");
+            MPI_Abort(comm, 1);
+        }
+
+        for (int i = 0; i < num_target_args; i++) { // Los archivos sin :clave usan -k
+            if (!des_targets_add(&targets, target_args[i], known_key, MAX_TEXT)) {
+                MPI_Abort(comm, 1);
+            }
+        }
+
+        if (strlen(search_word) == 0 && prefix.len == 0) {// Validar presencia de parámetro
+            fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n\n");
+            MPI_Abort(comm, 1);
         }
     }
 
     // Broadcast de todos los parámetros
     MPI_Bcast(&known_key, 1, MPI_LONG, 0, comm);
-    MPI_Bcast(&check_interval, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&complement, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&prefix, sizeof(prefix), MPI_BYTE, 0, comm);
     MPI_Bcast(search_word, 256, MPI_CHAR, 0, comm);
+    des_crib_init(&crib, search_word);
     MPI_Bcast(input_file, 256, MPI_CHAR, 0, comm);
+    des_targets_bcast(&targets, 0, comm);
+
+    if (targets.n > 0) {
+        if (id == 0) {
+            printf("DES BRUTE FORCE MPI - MULTIOBJETIVO\n");
+            printf("Palabra de búsqueda: \"%s\"\n", search_word);
+        }
+        if (!des_targets_index(&targets, &prefix, NULL)) {
+            fprintf(stderr, "Error: no se pudo preparar la tabla de objetivos\n");
+            MPI_Abort(comm, 1);
+        }
+        searchTargets(&targets, &prefix, &crib, comm);
+        des_targets_free(&targets);
+        MPI_Finalize();
+        return 0;
+    }
 
     unsigned char buffer[MAX_TEXT];
     int ciphlen = 0;
@@ -173,7 +380,16 @@ int main(int argc, char *argv[]) {
         if (ciphlen % 8 != 0)
             ciphlen += (8 - (ciphlen % 8));
 
+        // Bloque conocido P0 y bloque elegido ~P0, cifrados con la misma clave
+        for (int i = 0; i < 8; i++) {
+            known[0][i] = buffer[i];
+            known[2][i] = ~buffer[i];
+        }
+        encrypt(known_key, known[2], 8);
+        for (int i = 0; i < 8; i++) known[2][i] = ~known[2][i];
+
         encrypt(known_key, buffer, ciphlen);
+        memcpy(known[1], buffer, 8);
         printf("DES BRUTE FORCE MPI\n");
         printf("Clave usada para cifrar: %-30ld\n", known_key);
         printf("Palabra de búsqueda: \"%-33s\"\n", search_word);
@@ -182,79 +398,110 @@ int main(int argc, char *argv[]) {
 
     MPI_Bcast(&ciphlen, 1, MPI_INT, 0, comm);
     MPI_Bcast(buffer, ciphlen, MPI_UNSIGNED_CHAR, 0, comm);
+    verify_kernel = des_verify_select(ciphlen, &crib);
+    MPI_Bcast(known, sizeof(known), MPI_UNSIGNED_CHAR, 0, comm);
 
-    // Asignar rango de búsqueda a cada proceso
-    uint64_t upper = 1ULL << 56; // 2^56
-    long range_per_node = upper / N;
-    long mylower = range_per_node * id;
-    long myupper = (id == N - 1) ? upper : range_per_node * (id + 1);
+    // Rango de búsqueda, repartido por trozos a petición (des_sched.h)
+    uint64_t upper = DES_KEY_SPACE; // 2^56 claves distintas
+    if (complement) upper /= 2;     // representantes: cada uno cubre también ~k
 
     if (id == 0) {
         printf("Rango de búsqueda total: %ld\n", upper);
+        if (complement) printf("Modo complemento: k y ~k por cada cifrado\n");
+        if (prefix.len > 0) printf("Texto conocido: %d bytes\n", prefix.len);
+        printf("Reparto: dinámico desde el proceso 0 (trozos de ~%.2fs)\n", DES_SCHED_SECONDS);
+        printf("Kernel DES: %s (%d claves por lote)\n", des_bs_kernel_name, des_bs_lanes());
+        char kernel[96];
+        des_verify_describe(kernel, sizeof(kernel), ciphlen, &crib);
+        printf("Verificación: %s\n", kernel);
         printf("Iniciando búsqueda...\n\n");
     }
 
-    // Cada proceso imprime su rango
-    printf("Proceso %d: rango [%ld, %ld] - %ld claves\n", 
-           id, mylower, myupper, myupper - mylower); //DEBUG
-
     MPI_Barrier(comm); // Sincronizar antes de empezar
 
     start_time = MPI_Wtime();
 
-    // Recepción no bloqueante para detectar cuando otro proceso encuentra la clave
-    MPI_Irecv(&found, 1, MPI_LONG, MPI_ANY_SOURCE, 0, comm, &req);
+    // Bandera de parada en una ventana RMA del proceso 0 (ver des_stop.h)
+    des_stop_t stop;
+    des_stop_init(&stop, comm);
 
     long keys_tested = 0;
-    long last_report = mylower;
-    unsigned char temp_buffer[MAX_TEXT];
-
-    for (long key = mylower; key < myupper && found == 0; key++) {
-        keys_tested++;
+    long last_report = 0;
+    des_poll_t poll;
+    long hits[DES_BS_LANES];
+    unsigned char temp_buffer[MAX_TEXT + 8] __attribute__((aligned(64)));
+    static des_bs_keys batch_keys;
+    des_gray_t walk;
+    long key;
+    int count;
+
+    // Trozos del coordinador (proceso 0), cada uno por lotes en orden Gray: cada lote difiere
+    // del anterior en un bit de la clave base
+    des_sched_t sched;
+    long chunk_base, chunk_count;
+
+    des_bs_keys_init(&batch_keys);
+    des_sched_init(&sched, 0, upper, des_bs_lanes(), comm);
+    des_poll_init(&poll, DES_POLL_LATENCY, 0, start_time);
+    while (found == DES_STOP_NONE && des_sched_next(&sched, &chunk_base, &chunk_count)) {
+        des_gray_init(&walk, chunk_base, chunk_base + chunk_count, des_bs_lanes());
+        while (found == DES_STOP_NONE && des_gray_next(&walk, &key, &count)) {
+            keys_tested += complement ? 2 * count : count;
         
-        if (tryKey(key, buffer, ciphlen, temp_buffer, search_word)) {
-            found = key;
-            printf("\nProceso %d ENCONTRÓ LA CLAVE: %ld\n", id, key); //DEBUG
-            
-            // Notificar a todos los demás procesos
-            for (int node = 0; node < N; node++) {
-                if (node != id) {
-                    MPI_Send(&found, 1, MPI_LONG, node, 0, comm);
-                }
+            int num_hits;
+            if (complement) {
+                num_hits = tryKeysComplement(&batch_keys, key, count, known, buffer, ciphlen,
+                                             temp_buffer, &crib, hits);
+            } else if (prefix.len > 0) {
+                num_hits = tryKeysPrefix(&batch_keys, key, count, buffer, ciphlen, temp_buffer,
+                                         &crib, &prefix, hits);
+            } else {
+                num_hits = tryKeys(&batch_keys, key, count, buffer, ciphlen, temp_buffer, &crib, hits);
             }
-            break;
-        }
-        
-        // Cada CHECK_INTERVAL iteraciones, verificar si otro proceso encontró la clave
-        if (keys_tested % CHECK_INTERVAL == 0) {
-            MPI_Test(&req, &flag, &st);
-            if (flag && found != 0) {
-                printf("Proceso %d: deteniendo búsqueda (clave encontrada por proceso %d)\n", 
-                       id, st.MPI_SOURCE);
+            if (num_hits > 0) {
+                found = hits[0];
+                printf("\nProceso %d ENCONTRÓ LA CLAVE: %ld\n", id, found); //DEBUG
+            
+                // Notificar a todos los demás procesos
+                des_stop_post(&stop, found);
                 break;
             }
+        
+            // Cada DES_POLL_LATENCY segundos, verificar si otro proceso encontró la clave
+            if (des_poll_due(&poll)) {
+                des_poll_begin(&poll);
+                if (des_stop_check(&stop, NULL)) {
+                    found = stop.seen;
+                    printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", 
+                           id);
+                    break;
+                }
             
-            // Reporte de progreso cada 500k claves
-            if (id == 0 && (key - last_report) >= 500000) {
-                double elapsed = MPI_Wtime() - start_time;
-                long my_total_keys = (key - mylower);
-                long total_keys = my_total_keys * N; // Aproximado
-
-                double rate_process = my_total_keys / elapsed;
-                double rate = total_keys / elapsed;
-                double percent = (key * 100.0) / upper;
-
-                printf("(%.2f segundos) Proceso 0: %.0f claves/seg | En total: ~%.0f claves/seg\n", 
-                        elapsed, rate_process, rate);
-                last_report = key;
+                // Reporte de progreso cada 500k claves
+                if (id == 0 && (keys_tested - last_report) >= 500000) {
+                    double elapsed = poll.now - start_time;
+                    long my_total_keys = keys_tested;
+                    long total_keys = my_total_keys * N; // Aproximado
+
+                    double rate_process = my_total_keys / elapsed;
+                    double rate = total_keys / elapsed;
+                    double percent = (my_total_keys * 100.0) / upper;
+
+                    printf("(%.2f segundos) Proceso 0: %.0f claves/seg | En total: ~%.0f claves/seg\n", 
+                            elapsed, rate_process, rate);
+                    last_report = keys_tested;
+                }
             }
+
+            des_sched_serve(&sched);
         }
     }
+    des_sched_finish(&sched);
 
-    end_time = MPI_Wtime();
+    // Todos leen el valor final de la bandera
+    found = des_stop_finish(&stop);
 
-    // Asegurar que todos reciban la clave encontrada
-    MPI_Bcast(&found, 1, MPI_LONG, 0, comm);
+    end_time = MPI_Wtime();
 
     // Recolectar estadísticas de cada proceso
     long total_keys_tested;
@@ -264,8 +511,9 @@ int main(int argc, char *argv[]) {
         double total_time = end_time - start_time;
         
         printf("\nRESULTADOS \n");
-        if (found != 0) {
+        if (found != DES_STOP_NONE) {
             printf("Clave encontrada: %ld\n", found);
+            des_key_print_class(stdout, found);
             printf("Total de claves probadas: %ld\n", total_keys_tested);
             printf("Tiempo total: %.2f segundos\n", total_time);
             printf("Velocidad: %.0f claves/segundo\n", total_keys_tested / total_time);
@@ -5,19 +5,129 @@
 #include <omp.h>
 #include <openssl/des.h>
 #include <ctype.h>
+#include "../common/des_keys.h"
+#include "../common/des_bs.h"
+#include "../common/des_gray.h"
+#include "../common/des_prefix.h"
+#include "../common/des_verify.h"
+#include "../common/des_sched.h"
+#include "../common/des_stop.h"
+#include "../common/des_poll.h"
 
 #define MAX_TEXT 4096
-#define CHECK_INTERVAL 10000  // Revisar si otro proceso encontró la clave cada N iteraciones
+#define THREAD_CHUNK_BATCHES 64  // lotes que toma un thread de una vez del trozo del proceso
 
 // Buffer estático para evitar allocaciones repetidas (thread-local para MPI)
 static unsigned char temp_buffer[MAX_TEXT];
 
+// Núcleo de verificación para la longitud del mensaje y la palabra (des_verify_select)
+static des_verify_fn verify_kernel = des_verify_generic;
+
+// Estado compartido entre threads. MPI se inicializa con MPI_THREAD_FUNNELED: solo el thread
+// maestro (el que llamó a MPI_Init_thread) hace llamadas MPI; los demás solo leen y escriben
+// estas variables con operaciones atómicas.
+//
+// Bandera de parada y clave encontrada, cada una en su propia línea de caché para que la
+// lectura de cada lote no comparta línea con datos que se escriben.
+static struct {
+    int value;
+} __attribute__((aligned(64))) stop_flag;
+
+static struct {
+    long value;   // DES_STOP_NONE = ninguna (la clave 0 es un índice válido)
+} __attribute__((aligned(64))) local_found = { DES_STOP_NONE };
+
+// Contador de claves por thread, uno por línea de caché (sin falso compartir al sumarlos)
+typedef struct {
+    long keys;
+} __attribute__((aligned(64))) thread_counter_t;
+
+// Trozo del proceso (des_sched.h) repartido entre los threads: cada uno toma
+// THREAD_CHUNK_BATCHES lotes con un fetch_add sobre next. Los trozos no se reutilizan hasta
+// el final, así un thread que todavía tenga el puntero a uno agotado no toca el siguiente.
+typedef struct work_chunk {
+    long next;    // siguiente clave sin repartir (atómico)
+    long end;
+    struct work_chunk *older;
+} work_chunk_t;
+
+static struct {
+    work_chunk_t *current;    // trozo del que toman los threads
+    work_chunk_t *prefetch;   // siguiente trozo, ya pedido por el maestro
+    work_chunk_t *all;        // todos los trozos, para liberarlos al final
+    int ended;                // el coordinador no da más trozos
+} work;
+
+static inline int should_stop(void) {
+    return __atomic_load_n(&stop_flag.value, __ATOMIC_RELAXED);
+}
+
+// Solo el maestro: pide el siguiente trozo si no hay uno de reserva
+static void refill_work(des_sched_t *sched) {
+    long base, count;
+    int have_prefetch, ended;
+
+    #pragma omp critical(work)
+    {
+        have_prefetch = work.prefetch != NULL;
+        ended = work.ended;
+    }
+    if (have_prefetch || ended) return;
+
+    int got = des_sched_next(sched, &base, &count);
+    work_chunk_t *c = got ? malloc(sizeof(work_chunk_t)) : NULL;
+    if (c) {
+        c->next = base;
+        c->end = base + count;
+    }
+
+    #pragma omp critical(work)
+    {
+        if (c) {
+            c->older = work.all;
+            work.all = c;
+            work.prefetch = c;
+        } else {
+            work.ended = 1;
+        }
+    }
+}
+
+// Siguiente porción [*base, *base + *count) para este thread. Devuelve 1 si hay trabajo,
+// 0 si se acabó y -1 si hay que esperar a que el maestro traiga el siguiente trozo.
+static int take_work(long step, long *base, long *count) {
+    work_chunk_t *c = __atomic_load_n(&work.current, __ATOMIC_ACQUIRE);
+    int result = -1;
+
+    if (c) {
+        long b = __atomic_fetch_add(&c->next, step, __ATOMIC_RELAXED);
+        if (b < c->end) {
+            *base = b;
+            *count = (b + step < c->end) ? step : c->end - b;
+            return 1;
+        }
+    }
+
+    // Trozo agotado: pasar al de reserva (el primero que llega lo cambia)
+    #pragma omp critical(work)
+    {
+        if (work.current != c) {
+            result = -1;   // otro thread ya lo cambió: reintentar
+        } else if (work.prefetch) {
+            __atomic_store_n(&work.current, work.prefetch, __ATOMIC_RELEASE);
+            work.prefetch = NULL;
+        } else if (work.ended) {
+            result = 0;
+        }
+    }
+    return result;
+}
+
 void decrypt(long key, unsigned char *ciph, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -32,8 +142,7 @@ void encrypt(long key, unsigned char *plain, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -61,50 +170,108 @@ int isLikelyPlaintext(unsigned char *data, int len) {
     return (printable * 100 / check_len) > 90;
 }
 
-int tryKey(long key, unsigned char *ciph, int len, 
-                    unsigned char *temp_buffer, const char *search_word) {
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    unsigned char first_block[8];
-    
-    // Setup key UNA SOLA VEZ
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
+int tryKey(long key, unsigned char *ciph, int len,
+           unsigned char *temp_buffer, const des_crib_t *crib) {
+    des_sp_key ks;
     
-    // Quick check del primer bloque
-    memcpy(first_block, ciph, 8);
-    DES_ecb_encrypt((DES_cblock *)first_block,
-                    (DES_cblock *)first_block,
-                    &schedule,
-                    DES_DECRYPT);
+    // Subclaves desde el índice canónico (tablas de des_sp.h, sin OpenSSL)
+    des_sp_set_key(&ks, key);
     
-    if (!isLikelyPlaintext(first_block, 8)) {
-        return 0;  // Descarta sin descifrar todo
+    // Descifrado bloque a bloque: se descarta en el primer bloque que no es texto y la
+    // palabra se busca sobre la marcha (núcleo elegido al arrancar para ciphlen y la palabra)
+    return verify_kernel(&ks, ciph, len, crib, temp_buffer);
+}
+
+// Prueba `count` claves consecutivas desde base_key (hasta des_bs_lanes()) con el kernel
+// bitsliced y confirma con tryKey los carriles que pasan el filtro del primer bloque.
+// ks guarda el lote anterior para cargar de forma incremental los lotes en orden Gray.
+// Devuelve cuántas claves coincidieron y las deja en hits.
+int tryKeys(des_bs_keys *ks, long base_key, int count, unsigned char *ciph, int len,
+            unsigned char *temp_buffer, const des_crib_t *crib, long *hits) {
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+
+    uint64_t candidates[DES_BS_LANES / 64];
+    if (!des_bs_candidates(ks, count, ciph, candidates)) return 0;
+
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        while (candidates[w]) {
+            int lane = 64 * w + __builtin_ctzll(candidates[w]);
+            candidates[w] &= candidates[w] - 1;
+            if (tryKey(base_key + lane, ciph, len, temp_buffer, crib)) {
+                hits[num_hits++] = base_key + lane;
+            }
+        }
     }
-    
-    // Si pasa, descifrar el resto (reutilizando schedule)
-    memcpy(temp_buffer, ciph, len);
-    memcpy(temp_buffer, first_block, 8);  // Ya tenemos el primer bloque
-    
-    for (int i = 8; i < len; i += 8) {  // Empezar desde bloque 2
-        DES_ecb_encrypt((DES_cblock *)(temp_buffer + i),
-                        (DES_cblock *)(temp_buffer + i),
-                        &schedule,
-                        DES_DECRYPT);
+    return num_hits;
+}
+
+// Verificación completa de un acierto del modo texto conocido: el prefijo entero y, si se
+// dio con -s, la palabra de búsqueda
+int tryKeyPrefix(long key, unsigned char *ciph, int len, unsigned char *temp_buffer,
+                 const des_crib_t *crib, const des_prefix_t *prefix) {
+    des_sp_key ks;
+
+    des_sp_set_key(&ks, key);
+    des_sp_decrypt_all(&ks, ciph, len, temp_buffer);
+    return des_prefix_check(prefix, temp_buffer, len) && des_crib_search(crib, temp_buffer, len);
+}
+
+// Modo texto conocido (-p): cada clave cuesta descifrar el primer bloque y compararlo con
+// el prefijo; solo los aciertos se descifran enteros.
+int tryKeysPrefix(des_bs_keys *ks, long base_key, int count, unsigned char *ciph, int len,
+                  unsigned char *temp_buffer, const des_crib_t *crib,
+                  const des_prefix_t *prefix, long *hits) {
+    uint64_t matches[1][DES_BS_LANES / 64];
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+    if (!des_bs_match(ks, count, ciph, 0, &prefix->block, 1, prefix->care, matches)) return 0;
+
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        while (matches[0][w]) {
+            long key = base_key + 64 * w + __builtin_ctzll(matches[0][w]);
+            matches[0][w] &= matches[0][w] - 1;
+            if (tryKeyPrefix(key, ciph, len, temp_buffer, crib, prefix)) {
+                hits[num_hits++] = key;
+            }
+        }
     }
-    
-    temp_buffer[len] = 0;
-    return strstr((char *)temp_buffer, search_word) != NULL;
+    return num_hits;
+}
+
+// Modo complemento (-c): E_~k(~P) = ~E_k(P). Con el bloque conocido P0 -> C0 y el bloque
+// elegido ~P0 -> C1, un solo cifrado E_k(P0) prueba k (si da C0) y ~k (si da ~C1), así que
+// basta recorrer la mitad del espacio. known = {P0, C0, ~C1}.
+int tryKeysComplement(des_bs_keys *ks, long base_key, int count, const unsigned char known[3][8],
+                      unsigned char *ciph, int len, unsigned char *temp_buffer,
+                      const des_crib_t *crib, long *hits) {
+    uint64_t matches[2][DES_BS_LANES / 64];
+    int num_hits = 0;
+
+    des_bs_keys_load(ks, base_key, count);
+    if (!des_bs_match(ks, count, known[0], 1, known + 1, 2, NULL, matches)) return 0;
+
+    for (int t = 0; t < 2; t++) {
+        for (int w = 0; w < des_bs_lanes() / 64; w++) {
+            while (matches[t][w]) {
+                long key = base_key + 64 * w + __builtin_ctzll(matches[t][w]);
+                matches[t][w] &= matches[t][w] - 1;
+                if (t == 1) key = des_key_complement(key);
+                if (tryKey(key, ciph, len, temp_buffer, crib)) {
+                    hits[num_hits++] = key;
+                }
+            }
+        }
+    }
+    return num_hits;
 }
 
 int main(int argc, char *argv[]) {
     int N, id;
-    MPI_Status st;
-    MPI_Request req;
     MPI_Comm comm = MPI_COMM_WORLD;
-    long found = 0;
-    int flag = 0;
+    long found = DES_STOP_NONE;
     double start_time, end_time;
 
     // Parámetros configurables
@@ -112,19 +279,35 @@ int main(int argc, char *argv[]) {
     char search_word[256] = "";
     char input_file[256] = "input.txt";
     
-    // Parámetros automáticos del sistema
-    int check_interval = CHECK_INTERVAL;
-
-    MPI_Init(&argc, &argv);
+    int complement = 0;
+    unsigned char known[3][8];   // P0, C0, ~C1 para el modo complemento
+    des_prefix_t prefix = {0};   // texto conocido (-p)
+    des_crib_t crib;             // palabra de búsqueda lista para la verificación incremental
+
+    // Solo el thread maestro llama a MPI (los demás se comunican por variables atómicas)
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     MPI_Comm_size(comm, &N);
     MPI_Comm_rank(comm, &id);
+    if (provided < MPI_THREAD_FUNNELED) {
+        if (id == 0) fprintf(stderr, "Error: la biblioteca MPI no soporta MPI_THREAD_FUNNELED\n");
+        MPI_Abort(comm, 1);
+    }
+
+    des_bs_init();
+    des_bs_set_keymap(des_key_to_block);
 
     if (id == 0) {
+        if (!des_bs_selftest()) {
+            fprintf(stderr, "Error: el kernel DES bitsliced no coincide con OpenSSL\n");
+            MPI_Abort(comm, 1);
+        }
+
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) { // Llave de cifrado
                 known_key = atol(argv[++i]);
-                if (known_key <= 0) { // Validación de clave válida
-                    fprintf(stderr, "Error: La clave debe ser un número positivo\n");
+                if (known_key <= 0 || !des_key_valid(known_key)) { // Validación de clave válida
+                    fprintf(stderr, "Error: La clave debe estar entre 1 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(comm, 1);
                 }
             } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) { // Palabras clave a buscar en descifrado
@@ -135,28 +318,33 @@ int main(int argc, char *argv[]) {
                 }
             } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) { // Archivo con texto a cifrar (opcional)
                 strncpy(input_file, argv[++i], sizeof(input_file) - 1);
+            } else if (strcmp(argv[i], "-c") == 0) { // Modo complemento (bloque elegido ~P0)
+                complement = 1;
+            } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) { // Texto conocido (texto o 0xHEX)
+                if (!des_prefix_parse(&prefix, argv[++i])) {
+                    fprintf(stderr, "Error: prefijo inválido (texto o 0x seguido de hexadecimal)\n");
+                    MPI_Abort(comm, 1);
+                }
             }
         }
 
-        if (strlen(search_word) == 0) {
-            fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n\n");
+        if (prefix.len > 0 && complement) {
+            fprintf(stderr, "Error: -p y -c no se pueden combinar\n");
             MPI_Abort(comm, 1);
         }
 
-        // Ajustar check_interval basado en número de procesos
-        if (N >= 8) {
-            check_interval = 5000;  // Más frecuente con muchos procesos
-        } else if (N >= 4) {
-            check_interval = 10000;
-        } else {
-            check_interval = 20000;  // Menos frecuente con pocos procesos
+        if (strlen(search_word) == 0 && prefix.len == 0) {
+            fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n\n");
+            MPI_Abort(comm, 1);
         }
     }
 
     // Broadcast de todos los parámetros
     MPI_Bcast(&known_key, 1, MPI_LONG, 0, comm);
-    MPI_Bcast(&check_interval, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&complement, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&prefix, sizeof(prefix), MPI_BYTE, 0, comm);
     MPI_Bcast(search_word, 256, MPI_CHAR, 0, comm);
+    des_crib_init(&crib, search_word);
     MPI_Bcast(input_file, 256, MPI_CHAR, 0, comm);
 
     unsigned char buffer[MAX_TEXT];
@@ -174,7 +362,16 @@ int main(int argc, char *argv[]) {
         if (ciphlen % 8 != 0)
             ciphlen += (8 - (ciphlen % 8));
 
+        // Bloque conocido P0 y bloque elegido ~P0, cifrados con la misma clave
+        for (int i = 0; i < 8; i++) {
+            known[0][i] = buffer[i];
+            known[2][i] = ~buffer[i];
+        }
+        encrypt(known_key, known[2], 8);
+        for (int i = 0; i < 8; i++) known[2][i] = ~known[2][i];
+
         encrypt(known_key, buffer, ciphlen);
+        memcpy(known[1], buffer, 8);
         printf("DES BRUTE FORCE MPI\n");
         printf("Clave usada para cifrar: %-30ld\n", known_key);
         printf("Palabra de búsqueda: \"%-33s\"\n", search_word);
@@ -183,119 +380,155 @@ int main(int argc, char *argv[]) {
 
     MPI_Bcast(&ciphlen, 1, MPI_INT, 0, comm);
     MPI_Bcast(buffer, ciphlen, MPI_UNSIGNED_CHAR, 0, comm);
+    verify_kernel = des_verify_select(ciphlen, &crib);
+    MPI_Bcast(known, sizeof(known), MPI_UNSIGNED_CHAR, 0, comm);
 
-    // Calcular rango centrado en la clave (para claves grandes)
-    uint64_t upper = 1ULL << 56; // 2^56
-    long range_per_node = upper / N;
-    long mylower = range_per_node * id;
-    long myupper = (id == N - 1) ? upper : range_per_node * (id + 1);
+    // Rango de búsqueda, repartido por trozos a petición (des_sched.h)
+    uint64_t upper = DES_KEY_SPACE; // 2^56 claves distintas
+    if (complement) upper /= 2;     // representantes: cada uno cubre también ~k
+    int num_threads = omp_get_max_threads();
 
     if (id == 0) {
         printf("Rango de búsqueda total: %ld\n", upper);
+        if (complement) printf("Modo complemento: k y ~k por cada cifrado\n");
+        if (prefix.len > 0) printf("Texto conocido: %d bytes\n", prefix.len);
+        printf("Kernel DES: %s (%d claves por lote)\n", des_bs_kernel_name, des_bs_lanes());
+        char kernel[96];
+        des_verify_describe(kernel, sizeof(kernel), ciphlen, &crib);
+        printf("Verificación: %s\n", kernel);
+        printf("Reparto: trozos dinámicos entre procesos (~%.2fs), %d lotes por thread\n",
+               DES_SCHED_SECONDS, THREAD_CHUNK_BATCHES);
+        printf("Threads por proceso: %d\n", num_threads);
         printf("Iniciando búsqueda...\n\n");
     }
 
-    // Cada proceso imprime su rango
-    printf("Proceso %d: rango [%ld, %ld] - %ld claves\n", 
-           id, mylower, myupper, myupper - mylower); //DEBUG
-
     MPI_Barrier(comm); // Sincronizar antes de empezar
 
     start_time = MPI_Wtime();
 
-    // Recepción no bloqueante para detectar cuando otro proceso encuentra la clave
-    MPI_Irecv(&found, 1, MPI_LONG, MPI_ANY_SOURCE, 0, comm, &req);
+    // Bandera de parada en una ventana RMA del proceso 0; solo el maestro la toca
+    des_stop_t stop;
+    des_stop_init(&stop, comm);
 
     long keys_tested = 0;
-    long last_report = mylower;
-
-    #pragma omp parallel shared(found)
+    long last_report = 0;
+    thread_counter_t *counters = aligned_alloc(64, num_threads * sizeof(thread_counter_t));
+    des_sched_t sched;
+
+    memset(counters, 0, num_threads * sizeof(thread_counter_t));
+    des_sched_init(&sched, 0, upper, des_bs_lanes(), comm);
+    refill_work(&sched);                      // primer trozo ...
+    work.current = work.prefetch;
+    work.prefetch = NULL;
+    refill_work(&sched);                      // ... y el de reserva
+    des_poll_t poll;                          // solo lo usa el maestro
+    des_poll_init(&poll, DES_POLL_LATENCY, 0, start_time);
+
+    #pragma omp parallel num_threads(num_threads)
     {
-        unsigned char temp_buffer[MAX_TEXT];
-        long local_keys = 0;
+        unsigned char temp_buffer[MAX_TEXT + 8] __attribute__((aligned(64)));
+        long hits[DES_BS_LANES];
         int thread_id = omp_get_thread_num();
-        int num_threads_local = omp_get_num_threads();
-        
-        // Cada thread calcula su propio rango
-        long range = myupper - mylower;
-        long keys_per_thread = range / num_threads_local;
-        long my_start = mylower + (thread_id * keys_per_thread);
-        long my_end = (thread_id == num_threads_local - 1) ? myupper : my_start + keys_per_thread;
-        
-        // Loop manual - podemos usar break libremente
-        for (long key = my_start; key < my_end; key++) {
-            // Early exit instantáneo
-            if (found != 0) break;
-            
-            local_keys++;
-            
-            if (tryKey(key, buffer, ciphlen, temp_buffer, search_word)) {
-                #pragma omp critical
-                {
-                    if (found == 0) {
-                        found = key;
+        int is_master = thread_id == 0;   // el thread de MPI_Init_thread (FUNNELED)
+        thread_counter_t *counter = &counters[thread_id];
+        long step = (long)THREAD_CHUNK_BATCHES * des_bs_lanes();
+        long piece_base, piece_count;
+        int status;
+
+        // Lotes en orden Gray para que cada thread actualice sus claves bitsliced con una
+        // sola negación por lote
+        des_bs_keys *ks = aligned_alloc(64, sizeof(des_bs_keys));
+        des_gray_t walk;
+        long key;
+        int count;
+
+        des_bs_keys_init(ks);
+        while (!should_stop() && (status = take_work(step, &piece_base, &piece_count)) != 0) {
+            if (status < 0) {
+                // Sin trabajo hasta que el maestro traiga otro trozo
+                if (is_master) refill_work(&sched);
+                continue;
+            }
+
+            des_gray_init(&walk, piece_base, piece_base + piece_count, des_bs_lanes());
+            while (!should_stop() && des_gray_next(&walk, &key, &count)) {
+                int num_hits;
+                if (complement) {
+                    num_hits = tryKeysComplement(ks, key, count, known, buffer, ciphlen,
+                                                 temp_buffer, &crib, hits);
+                } else if (prefix.len > 0) {
+                    num_hits = tryKeysPrefix(ks, key, count, buffer, ciphlen, temp_buffer,
+                                             &crib, &prefix, hits);
+                } else {
+                    num_hits = tryKeys(ks, key, count, buffer, ciphlen, temp_buffer, &crib, hits);
+                }
+                __atomic_store_n(&counter->keys, counter->keys + (complement ? 2 * count : count),
+                                 __ATOMIC_RELAXED);
+
+                if (num_hits > 0) {
+                    // Sin MPI desde aquí: el maestro avisa a los demás procesos al salir
+                    long expected = DES_STOP_NONE;
+                    if (__atomic_compare_exchange_n(&local_found.value, &expected, hits[0], 0,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
                         printf("\n¡CLAVE ENCONTRADA!\n");
-                        printf("Proceso %d (Thread %d) encontró: %ld\n", id, thread_id, key);
-                        
-                        for (int node = 0; node < N; node++) {
-                            if (node != id) {
-                                MPI_Send(&found, 1, MPI_LONG, node, 0, comm);
-                            }
-                        }
+                        printf("Proceso %d (Thread %d) encontró: %ld\n", id, thread_id, hits[0]);
                     }
-                }
-                break;  // Salida inmediata
-            }
-            
-            // Check MPI solo en thread 0
-            if (thread_id == 0 && local_keys % check_interval == 0) {
-                MPI_Test(&req, &flag, &st);
-                if (flag && found != 0) {
-                    printf("Proceso %d: clave encontrada por otro proceso\n", id);
+                    __atomic_store_n(&stop_flag.value, 1, __ATOMIC_RELAXED);
                     break;
                 }
 
-                // Reporte de progreso detallado (solo proceso 0, thread 0)
-                if (id == 0 && thread_id == 0 && (key - last_report) >= 500000) {
-                    double elapsed = MPI_Wtime() - start_time;
-                    
-                    // Claves probadas por este thread hasta ahora
-                    long my_keys_so_far = key - my_start;
-
-                    // Claves probadas por este thread hasta ahora
-                    long rate_process = my_keys_so_far / elapsed;
-                    
-                    // ESTIMACIÓN: todos los threads avanzan similar
-                    long all_threads_keys = my_keys_so_far * num_threads_local;
-                    
-                    // ESTIMACIÓN: todos los procesos avanzan similar
-                    long total_keys_estimate = all_threads_keys * N;
-                    
-                    double rate = total_keys_estimate / elapsed;
-                    
-                    printf("(%.2f segundos) Proceso 0: %ld claves/seg | En total: ~%.0f claves/seg | Claves probadas ~%.0ld\n", 
-                        elapsed, rate_process, rate, total_keys_estimate);
-                    last_report = key;
+                if (!is_master) continue;
+
+                // Maestro: reserva de trabajo, peticiones de trozos y avisos de otros procesos
+                refill_work(&sched);
+                des_sched_serve(&sched);
+                if (des_poll_due(&poll)) {
+                    des_poll_begin(&poll);
+                    if (des_stop_check(&stop, NULL)) {
+                        printf("Proceso %d: clave encontrada por otro proceso\n", id);
+                        __atomic_store_n(&stop_flag.value, 1, __ATOMIC_RELAXED);
+                        break;
+                    }
+
+                    // Reporte de progreso (solo proceso 0): suma exacta de los threads
+                    if (id == 0 && (counter->keys - last_report) >= 500000) {
+                        double elapsed = poll.now - start_time;
+                        long process_keys = 0;
+                        for (int t = 0; t < num_threads; t++) {
+                            process_keys += __atomic_load_n(&counters[t].keys, __ATOMIC_RELAXED);
+                        }
+
+                        // ESTIMACIÓN: todos los procesos avanzan similar
+                        long total_keys_estimate = process_keys * N;
+                        double rate = total_keys_estimate / elapsed;
+
+                        printf("(%.2f segundos) Proceso 0: %.0f claves/seg | En total: ~%.0f claves/seg | Claves probadas ~%ld\n",
+                               elapsed, process_keys / elapsed, rate, total_keys_estimate);
+                        last_report = counter->keys;
+                    }
                 }
             }
         }
-        
-        #pragma omp atomic
-        keys_tested += local_keys;
+
+        free(ks);
     }
 
-    // IMPORTANTE: Cancelar la recepción pendiente antes de continuar
-    int test_flag;
-    MPI_Test(&req, &test_flag, &st);
-    if (!test_flag) {
-        MPI_Cancel(&req);
+    for (int t = 0; t < num_threads; t++) keys_tested += counters[t].keys;
+    free(counters);
+
+    // Fuera de la región paralela: avisar del hallazgo local y cerrar el reparto
+    if (local_found.value != DES_STOP_NONE) des_stop_post(&stop, local_found.value);
+    des_sched_finish(&sched);
+    while (work.all) {
+        work_chunk_t *older = work.all->older;
+        free(work.all);
+        work.all = older;
     }
-    MPI_Wait(&req, MPI_STATUS_IGNORE);
 
-    end_time = MPI_Wtime();
+    // Todos leen el valor final de la bandera
+    found = des_stop_finish(&stop);
 
-    // Asegurar que todos reciban la clave encontrada
-    MPI_Bcast(&found, 1, MPI_LONG, 0, comm);
+    end_time = MPI_Wtime();
 
     // Recolectar estadísticas de cada proceso
     long total_keys_tested;
@@ -305,8 +538,9 @@ int main(int argc, char *argv[]) {
         double total_time = end_time - start_time;
         
         printf("\nRESULTADOS \n");
-        if (found != 0) {
+        if (found != DES_STOP_NONE) {
             printf("Clave encontrada: %ld\n", found);
+            des_key_print_class(stdout, found);
             printf("Total de claves probadas: %ld\n", total_keys_tested);
             printf("Tiempo total: %.2f segundos\n", total_time);
             printf("Velocidad: %.0f claves/segundo\n", total_keys_tested / total_time);
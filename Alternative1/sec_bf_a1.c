@@ -4,6 +4,8 @@
 #include <openssl/des.h>
 #include <ctype.h>
 #include <time.h>
+#include "../common/des_keys.h"
+#include "../common/des_sp.h"
 
 #define MAX_TEXT 4096
 #define CHECK_INTERVAL 10000  // Revisar cada N iteraciones
@@ -15,8 +17,7 @@ void decrypt(long key, unsigned char *ciph, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -31,8 +32,7 @@ void encrypt(long key, unsigned char *plain, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -60,47 +60,49 @@ int isLikelyPlaintext(unsigned char *data, int len) {
     return (printable * 100 / check_len) > 90;
 }
 
-int tryKey(long key, unsigned char *ciph, int len, 
-                    unsigned char *temp_buffer, const char *search_word) {
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    unsigned char first_block[8];
-    
-    // Setup key UNA SOLA VEZ
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
-    
-    // Quick check del primer bloque
-    memcpy(first_block, ciph, 8);
-    DES_ecb_encrypt((DES_cblock *)first_block,
-                    (DES_cblock *)first_block,
-                    &schedule,
-                    DES_DECRYPT);
-    
-    if (!isLikelyPlaintext(first_block, 8)) {
-        return 0;  // Descarta sin descifrar todo
+// Prueba n <= DES_SP_WAYS claves a la vez con el DES escalar de des_sp.h: el primer bloque
+// se descifra para las n claves intercaladas partiendo de first_ip = IP(primer bloque
+// cifrado), calculado una sola vez. Si high no es NULL, todas las claves comparten sus bits
+// altos y las subclaves se obtienen con un XOR por ronda. Devuelve la posición de la clave
+// encontrada o -1.
+int tryKeys(const long *keys, int n, const des_sp_key *high, unsigned char *ciph,
+            uint64_t first_ip, int len, unsigned char *temp_buffer, const char *search_word) {
+    des_sp_key ks[DES_SP_WAYS];
+    const des_sp_key *kp[DES_SP_WAYS];
+    uint64_t state[DES_SP_WAYS];
+
+    for (int j = 0; j < n; j++) {
+        if (high) des_sp_key_low(&ks[j], high, (int)(keys[j] & 127));
+        else des_sp_set_key(&ks[j], keys[j]);
+        kp[j] = &ks[j];
+        state[j] = first_ip;
     }
-    
-    // Si pasa, descifrar el resto (reutilizando schedule)
-    memcpy(temp_buffer, ciph, len);
-    memcpy(temp_buffer, first_block, 8);  // Ya tenemos el primer bloque
-    
-    for (int i = 8; i < len; i += 8) {  // Empezar desde bloque 2
-        DES_ecb_encrypt((DES_cblock *)(temp_buffer + i),
-                        (DES_cblock *)(temp_buffer + i),
-                        &schedule,
-                        DES_DECRYPT);
+    des_sp_crypt(kp, n, state, 1);
+
+    for (int j = 0; j < n; j++) {
+        unsigned char first_block[8];
+
+        // Quick check del primer bloque (FP solo para mirar sus bytes)
+        des_sp_fp(state[j], first_block);
+        if (!isLikelyPlaintext(first_block, 8)) {
+            continue;  // Descarta sin descifrar todo
+        }
+
+        // Si pasa, descifrar el resto con las mismas subclaves
+        memcpy(temp_buffer, first_block, 8);
+        for (int i = 8; i < len; i += 8) {
+            des_sp_block(&ks[j], ciph + i, temp_buffer + i, 1);
+        }
+        temp_buffer[len] = 0;
+        if (strstr((char *)temp_buffer, search_word) != NULL) return j;
     }
-    
-    temp_buffer[len] = 0;
-    return strstr((char *)temp_buffer, search_word) != NULL;
+    return -1;
 }
 
 int main(int argc, char *argv[]) {
     int N = 1;         // procesos (secuencial)
     int id = 0;        // id del proceso (secuencial)
-    long found = 0;
+    long found = -1;
     double start_time, end_time;
 
     // Parámetros configurables
@@ -111,12 +113,18 @@ int main(int argc, char *argv[]) {
     // Parámetros automáticos del sistema
     int check_interval = CHECK_INTERVAL;
 
+    des_sp_init();
+    if (!des_sp_selftest()) {
+        fprintf(stderr, "Error: el DES escalar no coincide con OpenSSL\n");
+        return 1;
+    }
+
     // Parseo de argumentos (solo por id==0 en tu versión original)
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) { // Llave de cifrado
             known_key = atol(argv[++i]);
-            if (known_key <= 0) {
-                fprintf(stderr, "Error: La clave debe ser un número positivo\n");
+            if (known_key <= 0 || !des_key_valid(known_key)) {
+                fprintf(stderr, "Error: La clave debe estar entre 1 y %ld\n", DES_KEY_SPACE - 1);
                 return 1;
             }
         } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) { // Palabra clave
@@ -168,7 +176,7 @@ int main(int argc, char *argv[]) {
     printf("Archivo de entrada: %-35s\n", input_file);
 
     // Calcular rango centrado en la clave
-    uint64_t upper = 1ULL << 56; // 2^56
+    uint64_t upper = DES_KEY_SPACE; // 2^56 claves distintas
     long range_per_node = upper / N;
     long mylower = range_per_node * id;
     long myupper = (id == N - 1) ? upper : range_per_node * (id + 1);
@@ -184,14 +192,28 @@ int main(int argc, char *argv[]) {
 
     long keys_tested = 0;
     long last_report = mylower;
-    unsigned char temp_buffer[MAX_TEXT];
+    unsigned char temp_buffer[MAX_TEXT + 8];
+    uint64_t first_ip = des_sp_ip(buffer);   // el primer bloque pasa por IP una sola vez
+    des_sp_key high;
 
-    for (long key = mylower; key < myupper && found == 0; key++) {
-        keys_tested++;
+    // Grupos de DES_SP_WAYS claves consecutivas; las subclaves de los bits altos se
+    // recalculan cada 128 claves
+    for (long key = mylower; key < myupper && found == -1; key += DES_SP_WAYS) {
+        long keys[DES_SP_WAYS];
+        int n = (myupper - key < DES_SP_WAYS) ? (int)(myupper - key) : DES_SP_WAYS;
+
+        if (key == mylower || (key & 127) < DES_SP_WAYS) {
+            des_sp_set_key(&high, key & ~127L);
+        }
+        for (int j = 0; j < n; j++) keys[j] = key + j;
+        int same_high = ((key & 127) + n <= 128);
+        keys_tested += n;
 
-        if (tryKey(key, buffer, ciphlen, temp_buffer, search_word)) {
-            found = key;
-            printf("¡Clave encontrada: %ld!\n", key);
+        int hit = tryKeys(keys, n, same_high ? &high : NULL, buffer, first_ip, ciphlen,
+                          temp_buffer, search_word);
+        if (hit >= 0) {
+            found = keys[hit];
+            printf("¡Clave encontrada: %ld!\n", found);
             break;
         }
         
@@ -215,8 +237,9 @@ int main(int argc, char *argv[]) {
 
     printf("\nRESULTADOS \n");
     double total_time = end_time - start_time;
-    if (found != 0) {
+    if (found != -1) {
         printf("Clave encontrada: %ld\n", found);
+        des_key_print_class(stdout, found);
         printf("Total de claves probadas: %ld\n", total_keys_tested);
         printf("Tiempo total: %.2f segundos\n", total_time);
         printf("Velocidad: %.0f claves/segundo\n", (total_time > 0.0) ? (total_keys_tested / total_time) : 0.0);
@@ -4,19 +4,30 @@
 #include <mpi.h>
 #include <openssl/des.h>
 #include <ctype.h>
+#include "../common/des_keys.h"
+#include "../common/des_bs.h"
+#include "../common/des_gray.h"
+#include "../common/des_prefix.h"
+#include "../common/des_verify.h"
+#include "../common/des_mode.h"
+#include "../common/des_stop.h"
+#include "../common/des_poll.h"
+#include "../common/des_bands.h"
+#include "../common/des_hamming.h"
 
 #define MAX_TEXT 4096
-#define CHECK_INTERVAL 5000  // Verificar mensajes cada N iteraciones
 
 // Buffer estático para evitar allocaciones repetidas
 static unsigned char temp_buffer[MAX_TEXT];
 
+// Núcleo de verificación para la longitud del mensaje y la palabra (des_verify_select)
+static des_verify_fn verify_kernel = des_verify_generic;
+
 void decrypt(long key, unsigned char *ciph, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -31,8 +42,7 @@ void encrypt(long key, unsigned char *plain, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -58,98 +68,157 @@ int isLikelyPlaintext(unsigned char *data, int len) {
     return (printable * 100 / check_len) > 90;
 }
 
-// Descifra solo el primer bloque para filtrado rápido
-int quickCheckFirstBlock(long key, unsigned char *ciph) {
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    unsigned char first_block[8];
-    
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
+int tryKey(long key, unsigned char *ciph, int len,
+           unsigned char *temp_buffer, const des_crib_t *crib, const des_mode_t *mode) {
+    des_sp_key ks;
     
-    memcpy(first_block, ciph, 8);
-    DES_ecb_encrypt((DES_cblock *)first_block,
-                    (DES_cblock *)first_block,
-                    &schedule,
-                    DES_DECRYPT);
+    // Subclaves desde el índice canónico (tablas de des_sp.h, sin OpenSSL)
+    des_sp_set_key(&ks, key);
     
-    return isLikelyPlaintext(first_block, 8);
+    // Descifrado bloque a bloque: se descarta en el primer bloque que no es texto y la
+    // palabra se busca sobre la marcha (núcleo elegido al arrancar para ciphlen y la palabra;
+    // en CBC la versión encadenada)
+    if (mode->cbc) return des_verify_cbc(&ks, ciph, len, mode->iv, crib, temp_buffer);
+    return verify_kernel(&ks, ciph, len, crib, temp_buffer);
 }
 
-int tryKey(long key, unsigned char *ciph, int len, unsigned char *temp_buffer, const char *search_word) {
-    // Quick check del primer bloque
-    if (!quickCheckFirstBlock(key, ciph)) {
-        return 0;
+// Verificación completa de un acierto del modo texto conocido: el prefijo entero y, si se
+// dio con -s, la palabra de búsqueda
+int tryKeyPrefix(long key, unsigned char *ciph, int len, unsigned char *temp_buffer,
+                 const des_crib_t *crib, const des_prefix_t *prefix, const des_mode_t *mode) {
+    des_sp_key ks;
+
+    des_sp_set_key(&ks, key);
+    des_sp_decrypt_cbc(&ks, ciph, len, des_mode_iv(mode), temp_buffer);
+    return des_prefix_check(prefix, temp_buffer, len) && des_crib_search(crib, temp_buffer, len);
+}
+
+// Prueba un lote de hasta des_bs_lanes() claves con el kernel bitsliced: las `count` claves
+// consecutivas desde base_key o, si batch no es NULL, las del lote (no necesariamente
+// consecutivas, transposición completa). Confirma los carriles que pasan el filtro del primer bloque: el de texto
+// (tryKey) o, con texto conocido (-p), la comparación exacta con el prefijo. En CBC el
+// filtro mira D(C0) ^ IV (el prefijo ya lleva el IV aplicado: des_mode_adjust_prefix).
+// Con rangos, ks conserva las claves del lote anterior: recorriendo cada lado de una banda en
+// orden Gray (des_gray_next) la carga es incremental. Devuelve cuántas claves coincidieron y las deja
+// en hits.
+int tryKeys(des_bs_keys *ks, const long *batch, long base_key, int count, unsigned char *ciph, int len,
+            unsigned char *temp_buffer, const des_crib_t *crib,
+            const des_prefix_t *prefix, const des_mode_t *mode, long *hits) {
+    uint64_t candidates[1][DES_BS_LANES / 64];
+    int num_hits = 0;
+
+    if (batch) {
+        DES_cblock keys[DES_BS_LANES];
+        for (int i = 0; i < count; i++) des_key_to_block(batch[i], &keys[i]);
+        des_bs_keys_from_blocks(ks, keys, count);
+    } else {
+        des_bs_keys_load(ks, base_key, count);
     }
-    
-    // Descifrar todo usando buffer estático
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
-    
-    memcpy(temp_buffer, ciph, len);
-    
-    for (int i = 0; i < len; i += 8) {
-        DES_ecb_encrypt((DES_cblock *)(temp_buffer + i),
-                        (DES_cblock *)(temp_buffer + i),
-                        &schedule,
-                        DES_DECRYPT);
+
+    if (prefix->len > 0) {
+        if (!des_bs_match(ks, count, ciph, 0, &prefix->block, 1, prefix->care, candidates)) return 0;
+    } else {
+        if (!des_bs_candidates_iv(ks, count, ciph, des_mode_iv(mode), candidates[0])) return 0;
     }
-    
-    temp_buffer[len] = 0;
-    return strstr((char *)temp_buffer, search_word) != NULL;
+
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        while (candidates[0][w]) {
+            int lane = 64 * w + __builtin_ctzll(candidates[0][w]);
+            long key = batch ? batch[lane] : base_key + lane;
+            candidates[0][w] &= candidates[0][w] - 1;
+            int ok = prefix->len > 0
+                ? tryKeyPrefix(key, ciph, len, temp_buffer, crib, prefix, mode)
+                : tryKey(key, ciph, len, temp_buffer, crib, mode);
+            if (ok) {
+                hits[num_hits++] = key;
+            }
+        }
+    }
+    return num_hits;
+}
+
+// Distancia entre una clave y una pista: en bits con --hamming (hamming >= 0), numérica si no
+long hintDistance(long key, long hint, int hamming) {
+    return hamming >= 0 ? des_hamming_distance(key, hint) : labs(key - hint);
+}
+
+// Pista más cercana a la clave (la que explica el hallazgo en las estadísticas)
+int nearestHint(const des_bands_t *bands, long key, int hamming) {
+    int best = 0;
+    for (int i = 1; i < bands->n; i++) {
+        if (hintDistance(key, bands->hint[i].key, hamming) <
+            hintDistance(key, bands->hint[best].key, hamming)) best = i;
+    }
+    return best;
 }
 
 int main(int argc, char *argv[]) {
     int N, id;
-    MPI_Status st;
-    MPI_Request req;
     MPI_Comm comm = MPI_COMM_WORLD;
-    long found = 0;
-    int flag = 0;
+    long found = DES_STOP_NONE;
     double start_time, end_time;
 
     // Parámetros configurables
     long real_key = 0L;      // Clave REAL para cifrar (simula la clave del atacante original)
-    long hint_key = 0L;      // Pista/aproximación (lo que sabe el que hace brute force)
-    long search_radius = 1000000L;
+    des_bands_t bands = {0}; // Pistas/aproximaciones (lo que sabe el que hace brute force)
+    long search_radius = 1000000L;   // radio de las pistas que no dan el suyo
+    int hamming = -1;        // --hamming: distancia de Hamming máxima (-1 = búsqueda numérica)
     char search_word[256] = "";
     char input_file[256] = "input.txt";
-    int check_interval = CHECK_INTERVAL;
     int has_real_key = 0;
-    int has_hint = 0;
+    des_prefix_t prefix = {0};   // texto conocido (-p)
+    des_crib_t crib;             // palabra de búsqueda lista para la verificación incremental
+    des_mode_t mode = {0};       // --mode/--iv (ECB por defecto)
+    int has_iv = 0;
 
     MPI_Init(&argc, &argv);
     MPI_Comm_size(comm, &N);
     MPI_Comm_rank(comm, &id);
 
+    des_bs_init();
+    des_bs_set_keymap(des_key_to_block);
+
     // Proceso 0: parsear argumentos
     if (id == 0) {
+        if (!des_bs_selftest()) {
+            fprintf(stderr, "Error: el kernel DES bitsliced no coincide con OpenSSL\n");
+            MPI_Abort(comm, 1);
+        }
+
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
                 real_key = atol(argv[++i]);
-                if (real_key < 0 || real_key >= (1L << 56)) {
-                    fprintf(stderr, "Error: La clave debe estar entre 0 y %ld\n", (1L << 56) - 1);
+                if (!des_key_valid(real_key)) {
+                    fprintf(stderr, "Error: La clave debe estar entre 0 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(comm, 1);
                 }
                 has_real_key = 1;
             } else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc) {
-                hint_key = atol(argv[++i]);
-                if (hint_key < 0 || hint_key >= (1L << 56)) {
-                    fprintf(stderr, "Error: La pista debe estar entre 0 y %ld\n", (1L << 56) - 1);
+                if (bands.n == DES_HINTS_MAX || !des_hint_parse(&bands.hint[bands.n], argv[++i])) {
+                    fprintf(stderr, "Error: pista inválida (clave[:peso[:radio]], hasta %d pistas)\n",
+                            DES_HINTS_MAX);
+                    MPI_Abort(comm, 1);
+                }
+                bands.n++;
+            } else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+                if (!des_bands_load(&bands, argv[++i])) {
+                    fprintf(stderr, "Error: no se pudo leer las pistas de %s (clave [peso [radio]] por línea)\n",
+                            argv[i]);
                     MPI_Abort(comm, 1);
                 }
-                has_hint = 1;
             } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
                 search_radius = atol(argv[++i]);
                 if (search_radius <= 0) {
                     fprintf(stderr, "Error: El radio debe ser positivo\n");
                     MPI_Abort(comm, 1);
                 }
+            } else if (strcmp(argv[i], "--hamming") == 0 && i + 1 < argc) {
+                hamming = atoi(argv[++i]);
+                if (hamming < 0 || hamming > DES_HAMMING_BITS) {
+                    fprintf(stderr, "Error: La distancia de Hamming debe estar entre 0 y %d\n",
+                            DES_HAMMING_BITS);
+                    MPI_Abort(comm, 1);
+                }
             } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
                 strncpy(search_word, argv[++i], sizeof(search_word) - 1);
                 if (strlen(search_word) == 0) {
@@ -158,6 +227,22 @@ int main(int argc, char *argv[]) {
                 }
             } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
                 strncpy(input_file, argv[++i], sizeof(input_file) - 1);
+            } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+                if (!des_mode_parse(&mode, argv[++i])) {
+                    fprintf(stderr, "Error: modo inválido (ecb o cbc)\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "--iv") == 0 && i + 1 < argc) {
+                if (!des_mode_parse_iv(&mode, argv[++i])) {
+                    fprintf(stderr, "Error: IV inválido (16 dígitos hexadecimales)\n");
+                    MPI_Abort(comm, 1);
+                }
+                has_iv = 1;
+            } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+                if (!des_prefix_parse(&prefix, argv[++i])) {
+                    fprintf(stderr, "Error: prefijo inválido (texto o 0x seguido de hexadecimal)\n");
+                    MPI_Abort(comm, 1);
+                }
             }
         }
 
@@ -166,43 +251,61 @@ int main(int argc, char *argv[]) {
             fprintf(stderr, "Error: Debe proporcionar la clave real con -k\n");
             fprintf(stderr, "Uso: %s -k <clave_real> -h <pista> -r <radio> -s <palabra> [-f <archivo>]\n", argv[0]);
             fprintf(stderr, "\n-k <clave_real>: La clave REAL usada para cifrar el archivo\n");
-            fprintf(stderr, "-h <pista>:      Aproximación/pista de donde podría estar la clave\n");
-            fprintf(stderr, "-r <radio>:      Radio de búsqueda alrededor de la pista\n");
+            fprintf(stderr, "-h <pista>:      Aproximación/pista de donde podría estar la clave; se repite\n");
+            fprintf(stderr, "                 como -h clave:peso:radio para varias pistas de distinta confianza\n");
+            fprintf(stderr, "-H <archivo>:    Pistas desde un archivo (clave [peso [radio]] por línea)\n");
+            fprintf(stderr, "-r <radio>:      Radio de búsqueda de las pistas que no dan el suyo\n");
+            fprintf(stderr, "--hamming <d>:   Buscar las claves a distancia de Hamming 0..d de las pistas\n");
+            fprintf(stderr, "                 (bits de la clave invertidos) en vez de pista ± radio\n");
             fprintf(stderr, "-s <palabra>:    Palabra que debe aparecer en el texto descifrado\n");
             fprintf(stderr, "-f <archivo>:    Archivo de entrada (default: input.txt)\n");
+            fprintf(stderr, "-p <prefijo>:    Inicio conocido del texto (texto o 0xHEX); -s opcional\n");
+            fprintf(stderr, "--mode cbc --iv <hex>: Mensaje cifrado en CBC con IV de 16 dígitos hex\n");
             fprintf(stderr, "\nEjemplo: %s -k 123456 -h 120000 -r 10000 -s \"secret\"\n", argv[0]);
             fprintf(stderr, "  Cifra con clave 123456, busca desde 120000 ±10000\n");
+            fprintf(stderr, "Ejemplo: %s -k 123456 -h 120000:3:10000 -h 500000:1:50000 -s \"secret\"\n", argv[0]);
+            fprintf(stderr, "  Dos pistas; las bandas más probables por clave se prueban primero\n");
             MPI_Abort(comm, 1);
         }
 
-        if (!has_hint) {
+        if (bands.n == 0) {
             fprintf(stderr, "Error: Debe proporcionar una pista de la clave con -h\n");
             fprintf(stderr, "Uso: %s -k <clave_real> -h <pista> -r <radio> -s <palabra> [-f <archivo>]\n", argv[0]);
             MPI_Abort(comm, 1);
         }
 
-        if (strlen(search_word) == 0) {
+        for (int h = 0; h < bands.n; h++) {
+            if (!des_key_valid(bands.hint[h].key)) {
+                fprintf(stderr, "Error: La pista debe estar entre 0 y %ld\n", DES_KEY_SPACE - 1);
+                MPI_Abort(comm, 1);
+            }
+            if (bands.hint[h].radius == 0) bands.hint[h].radius = search_radius;
+        }
+
+        if (strlen(search_word) == 0 && prefix.len == 0) {
             fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n");
             fprintf(stderr, "Uso: %s -k <clave_real> -h <pista> -r <radio> -s <palabra> [-f <archivo>]\n", argv[0]);
             MPI_Abort(comm, 1);
         }
 
-        // Ajustar check_interval según número de procesos
-        if (N >= 8) {
-            check_interval = 3000;
-        } else if (N >= 4) {
-            check_interval = 5000;
-        } else {
-            check_interval = 10000;
+        if (mode.cbc && !has_iv) {
+            fprintf(stderr, "Error: --mode cbc necesita --iv\n");
+            MPI_Abort(comm, 1);
         }
+
+        // El filtro de -p compara D(C0), que en CBC es P0 ^ IV
+        des_mode_adjust_prefix(&mode, &prefix);
     }
 
     // Broadcast de parámetros (SOLO la pista y parámetros de búsqueda)
     // La clave real NO se broadcastea - solo proceso 0 la necesita para cifrar
-    MPI_Bcast(&hint_key, 1, MPI_LONG, 0, comm);
-    MPI_Bcast(&search_radius, 1, MPI_LONG, 0, comm);
-    MPI_Bcast(&check_interval, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&bands, sizeof(bands), MPI_BYTE, 0, comm);
+    MPI_Bcast(&hamming, 1, MPI_INT, 0, comm);
+    des_hamming_init();
     MPI_Bcast(search_word, 256, MPI_CHAR, 0, comm);
+    des_crib_init(&crib, search_word);
+    MPI_Bcast(&prefix, sizeof(prefix), MPI_BYTE, 0, comm);
+    MPI_Bcast(&mode, sizeof(mode), MPI_BYTE, 0, comm);
     MPI_Bcast(input_file, 256, MPI_CHAR, 0, comm);
 
     unsigned char buffer[MAX_TEXT];
@@ -222,133 +325,262 @@ int main(int argc, char *argv[]) {
             ciphlen += (8 - (ciphlen % 8));
 
         // Cifrar con la clave REAL (simula el cifrado del atacante original)
-        encrypt(real_key, buffer, ciphlen);
+        des_mode_crypt(&mode, real_key, buffer, ciphlen, 1);
 
         printf("=== DES BRUTE FORCE - BÚSQUEDA RADIAL CON PISTA ===\n");
         printf("\n[SIMULACIÓN]\n");
         printf("Clave REAL usada para cifrar: %ld\n", real_key);
         printf("(En un ataque real, esta clave es desconocida)\n");
         printf("\n[PARÁMETROS DE BÚSQUEDA]\n");
-        printf("Pista proporcionada: %ld\n", hint_key);
-        printf("Distancia de la pista a la clave real: %ld\n", labs(real_key - hint_key));
-        printf("Radio de búsqueda: %ld\n", search_radius);
-        printf("Rango de exploración: [%ld, %ld]\n", 
-               hint_key - search_radius, 
-               hint_key + search_radius);
-        
+        double total_weight = 0;
+        long search_space = 0;
+        int in_range = 0;
+        for (int h = 0; h < bands.n; h++) {
+            total_weight += bands.hint[h].weight;
+            search_space += bands.hint[h].radius * 2 + 1;
+        }
+        if (hamming >= 0) {
+            search_space = 0;
+            for (int d = 0; d <= hamming; d++) search_space += des_hamming_count(d) * bands.n;
+        }
+        for (int h = 0; h < bands.n && hamming >= 0; h++) {
+            printf("Pista %d: %ld - distancia de Hamming a la clave real: %d bits\n",
+                   h, bands.hint[h].key, des_hamming_distance(real_key, bands.hint[h].key));
+            if (des_hamming_distance(real_key, bands.hint[h].key) <= hamming) in_range = 1;
+        }
+        for (int h = 0; h < bands.n && hamming < 0; h++) {
+            des_hint_t *hint = &bands.hint[h];
+            printf("Pista %d: %ld (peso %.2f, radio %ld, rango [%ld, %ld]) - distancia a la clave real: %ld\n",
+                   h, hint->key, hint->weight / total_weight, hint->radius,
+                   hint->key - hint->radius, hint->key + hint->radius, labs(real_key - hint->key));
+            if (labs(real_key - hint->key) <= hint->radius) in_range = 1;
+        }
+
         // Verificar si la clave está en el rango
-        if (real_key >= hint_key - search_radius && real_key <= hint_key + search_radius) {
+        if (in_range) {
             printf("✓ La clave ESTÁ dentro del rango de búsqueda\n");
         } else {
             printf("✗ ADVERTENCIA: La clave NO está en el rango de búsqueda\n");
             printf("  Necesitarás un radio mayor o una mejor pista\n");
         }
         
-        printf("\nEspacio de búsqueda: ~%ld claves\n", search_radius * 2);
+        printf("\nEspacio de búsqueda: ~%ld claves\n", search_space);
         printf("Palabra de búsqueda: \"%s\"\n", search_word);
+        if (prefix.len > 0) printf("Texto conocido: %d bytes\n", prefix.len);
         printf("Archivo: %s (%d bytes)\n", input_file, ciphlen);
         printf("Procesos MPI: %d\n", N);
         printf("\nDistribución de trabajo:\n");
-        printf("  Cada proceso explora radios intercalados desde la pista\n");
-        printf("  P0: radios 0, %d, %d, ...\n", N, 2*N);
-        if (N > 1) printf("  P1: radios 1, %d, %d, ...\n", N+1, 2*N+1);
-        if (N > 2) printf("  ...\n");
-        printf("Intervalo de verificación: cada %d claves\n\n", check_interval);
+        if (hamming >= 0) {
+            printf("  Capas de Hamming 0..%d de cada pista, de menor a mayor distancia\n", hamming);
+            printf("  Cada proceso recorre su tramo de cada capa (numeración combinatoria)\n");
+        } else {
+            printf("  %ld bandas de %ld distancias, de mayor a menor probabilidad por clave\n",
+                   des_bands_count(&bands), DES_BAND_WIDTH);
+            printf("  Cada proceso pide la siguiente banda a un contador compartido (RMA)\n");
+        }
+        printf("Intervalo de verificación: cada %.0f ms\n", DES_POLL_LATENCY * 1e3);
+        char kernel[96];
+        des_verify_describe(kernel, sizeof(kernel), ciphlen, &crib);
+        printf("Modo: %s\n", des_mode_name(&mode));
+        printf("Verificación: %s\n", mode.cbc ? "general CBC (encadenada)" : kernel);
+        printf("Kernel DES: %s (%d claves por lote)\n\n", des_bs_kernel_name, des_bs_lanes());
         printf("Iniciando búsqueda radial desde pista...\n");
     }
 
     // Broadcast del texto cifrado
     MPI_Bcast(&ciphlen, 1, MPI_INT, 0, comm);
     MPI_Bcast(buffer, ciphlen, MPI_UNSIGNED_CHAR, 0, comm);
+    verify_kernel = des_verify_select(ciphlen, &crib);
 
-    // Calcular claves totales aproximadas
-    long total_keys_estimate = search_radius * 2;
-    long keys_per_process = total_keys_estimate / N;
-
-    printf("Proceso %d: ~%ld claves a explorar\n", id, keys_per_process);
+    long total_bands = des_bands_count(&bands);
 
     MPI_Barrier(comm);
     start_time = MPI_Wtime();
 
-    // Recepción no bloqueante
-    MPI_Irecv(&found, 1, MPI_LONG, MPI_ANY_SOURCE, 0, comm, &req);
+    // Bandera de parada y contador de bandas en ventanas RMA del proceso 0
+    des_stop_t stop;
+    des_stop_init(&stop, comm);
+    des_counter_t counter;
+    des_counter_init(&counter, comm);
 
     long keys_tested = 0;
     long last_report_time = 0;
-    unsigned char local_temp_buffer[MAX_TEXT];
+    unsigned char local_temp_buffer[MAX_TEXT + 8] __attribute__((aligned(64)));
+
+    long batch[DES_BS_LANES];
+    long hits[DES_BS_LANES];
+    int lanes = des_bs_lanes();
+    des_bs_keys batch_keys;
+    des_bs_keys_init(&batch_keys);
+    des_poll_t poll;
+
+    des_poll_init(&poll, DES_POLL_LATENCY, 0, start_time);
+
+    // Búsqueda radial por bandas: cada proceso pide al contador compartido la siguiente banda
+    // del orden de prioridad (des_bands.h) y recorre sus dos lados, [pista - d1 + 1, pista - d0]
+    // y [pista + d0, pista + d1), como rangos contiguos en lotes Gray para el kernel bitsliced.
+    //
+    // Un acierto no detiene la búsqueda en seco: la banda se termina entera para quedarse con
+    // el acierto más cercano a la pista, y en la bandera de parada se publica su posición en el
+    // orden (des_bands_position), no la clave. Las bandas posteriores se abandonan; las
+    // anteriores, que ya tienen dueño porque el contador solo avanza, se terminan porque
+    // pueden tener un acierto mejor. Al final un MPI_Allreduce con el mínimo confirma cuál es.
+    long best = DES_STOP_EMPTY;   // posición del mejor acierto de este proceso
+    long best_key = LONG_MAX;     // con --hamming, el menor acierto de la capa best
+    long fence = LONG_MAX;        // primera banda (o capa) posterior al mejor acierto publicado
+    int hint;
+    long band, d0, d1;
+
+    // Con --hamming las capas se recorren en orden, d = 0, 1, ... y dentro de cada d una
+    // pista tras otra (capa número d * pistas + pista). Todos los procesos pasan por todas las
+    // capas, cada uno por su tramo, así que no hace falta el contador; la parada es igual que
+    // con bandas, con la capa en la bandera en vez de la posición.
+    for (int d = 0; d <= hamming && d * bands.n < fence; d++) {
+        for (hint = 0; hint < bands.n; hint++) {
+            long shell = (long)d * bands.n + hint;
+            long center = bands.hint[hint].key;
+            uint64_t first, count;
+            des_hamming_slice(d, id, N, &first, &count);
+            if (shell >= fence) break;
+
+            uint64_t mask = des_hamming_unrank(d, first);
+            int batch_count = 0;
+            for (uint64_t i = 0; i < count && shell < fence; i++) {
+                batch[batch_count++] = center ^ (long)mask;
+                mask = des_hamming_next(mask);
+                if (batch_count < lanes && i < count - 1) continue;
+                keys_tested += batch_count;
+
+                int num_hits = tryKeys(&batch_keys, batch, 0, batch_count, buffer, ciphlen,
+                                       local_temp_buffer, &crib, &prefix, &mode, hits);
+                for (int j = 0; j < num_hits; j++) {
+                    if (shell < best) {
+                        best = shell;
+                        best_key = hits[j];
+                    } else if (shell == best && hits[j] < best_key) {
+                        best_key = hits[j];
+                    }
+                }
+                batch_count = 0;
+
+                if (des_poll_due(&poll)) {
+                    des_poll_begin(&poll);
+                    // Mínimo actual: otro proceso puede haber publicado una capa anterior
+                    // después de la que ya se vio. Las capas posteriores a la publicada no
+                    // pueden ganar; la publicada se termina.
+                    long posted;
+                    if (des_stop_refresh(&stop, &posted) && posted + 1 < fence) {
+                        if (shell < fence && shell > posted) {
+                            printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", 
+                                   id);
+                        }
+                        fence = posted + 1;
+                    }
 
-    // Búsqueda radial: cada proceso explora capas intercaladas desde la PISTA
-    for (long radius = id; radius <= search_radius && found == 0; radius += N) {
-        
-        // Generar claves en esta capa (bidireccional desde la pista)
-        long keys_in_layer[2];
-        int valid_keys = 0;
-
-        // Lado negativo (pista - radio)
-        long key_minus = hint_key - radius;
-        if (key_minus >= 0 && key_minus < (1L << 56)) {
-            keys_in_layer[valid_keys++] = key_minus;
-        }
+                    // Reporte de progreso (solo proceso 0)
+                    double elapsed = poll.now - start_time;
+                    if (fence == LONG_MAX && id == 0 && elapsed - last_report_time >= 2.0) {
+                        long approx_total = keys_tested * N;
+                        double rate = approx_total / elapsed;
+                        printf("Progreso: capa %d/%d (pista %d) - %.2f%% de la capa - %.0f claves/seg (%.2fs)\n", 
+                               d, hamming, hint, (double)i * 100.0 / count, rate, elapsed);
+                        last_report_time = elapsed;
+                    }
+                }
+            }
 
-        // Lado positivo (pista + radio), evitar duplicado en radius=0
-        if (radius > 0) {
-            long key_plus = hint_key + radius;
-            if (key_plus >= 0 && key_plus < (1L << 56)) {
-                keys_in_layer[valid_keys++] = key_plus;
+            // Acierto en esta capa: publicarla
+            if (shell < fence && best == shell) {
+                printf("\n>>> Proceso %d ENCONTRÓ LA CLAVE: %ld <<<\n", id, best_key);
+                printf("    Distancia de Hamming desde pista %d: %d bits\n", hint, d);
+                des_stop_post(&stop, best);
+                fence = shell + 1;
             }
         }
+    }
 
-        // Probar claves en esta capa
-        for (int k = 0; k < valid_keys && found == 0; k++) {
-            long key = keys_in_layer[k];
-            keys_tested++;
-
-            // Probar la clave
-            if (tryKey(key, buffer, ciphlen, local_temp_buffer, search_word)) {
-                found = key;
-                printf("\n>>> Proceso %d ENCONTRÓ LA CLAVE: %ld <<<\n", id, key);
-                printf("    Radio desde pista: %ld\n", radius);
-                printf("    Distancia desde pista: %ld\n", labs(key - hint_key));
-                
-                // Notificar a todos los demás procesos
-                for (int node = 0; node < N; node++) {
-                    if (node != id) {
-                        MPI_Send(&found, 1, MPI_LONG, node, 0, comm);
-                    }
+    while (hamming < 0 && (band = des_counter_next(&counter)) < total_bands && band < fence &&
+           des_bands_get(&bands, band, &hint, &d0, &d1)) {
+        long center = bands.hint[hint].key;
+
+        for (int side = 0; side < 2 && band < fence; side++) {
+            long lo = side ? center + (d0 > 0 ? d0 : 1) : center - d1 + 1;
+            long hi = side ? center + d1 : center - d0 + 1;
+            if (lo < 0) lo = 0;
+            if (hi > DES_KEY_SPACE) hi = DES_KEY_SPACE;
+            if (lo >= hi) continue;
+
+            des_gray_t walk;
+            long base;
+            int count;
+            des_gray_init(&walk, lo, hi, lanes);
+            while (band < fence && des_gray_next(&walk, &base, &count)) {
+                keys_tested += count;
+
+                int num_hits = tryKeys(&batch_keys, NULL, base, count, buffer, ciphlen, local_temp_buffer,
+                                       &crib, &prefix, &mode, hits);
+                for (int i = 0; i < num_hits; i++) {
+                    long position = des_bands_position(band, d0, center, hits[i]);
+                    if (position < best) best = position;
                 }
-                break;
-            }
 
-            // Verificar periódicamente si otro proceso encontró la clave
-            if (keys_tested % check_interval == 0) {
-                MPI_Test(&req, &flag, &st);
-                if (flag && found != 0) {
-                    printf("Proceso %d: deteniendo búsqueda (clave encontrada por proceso %d)\n", 
-                           id, st.MPI_SOURCE);
-                    break;
+                // Verificar periódicamente si otro proceso encontró una clave en una banda anterior
+                if (des_poll_due(&poll)) {
+                    des_poll_begin(&poll);
+                    // Mínimo actual (ver las capas de Hamming): se terminan las bandas
+                    // hasta la publicada y no se piden más allá
+                    long posted;
+                    if (des_stop_refresh(&stop, &posted) && des_bands_band(posted) + 1 < fence) {
+                        if (band < fence && band > des_bands_band(posted)) {
+                            printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", 
+                                   id);
+                        }
+                        fence = des_bands_band(posted) + 1;
+                    }
+
+                    // Reporte de progreso (solo proceso 0)
+                    double elapsed = poll.now - start_time;
+                    if (fence == LONG_MAX && id == 0 && elapsed - last_report_time >= 2.0) {
+                        double progress = ((double)band * 100.0) / total_bands;
+                        long approx_total = keys_tested * N;
+                        double rate = approx_total / elapsed;
+                        printf("Progreso: %.2f%% - Banda: %ld/%ld (pista %d) - %.0f claves/seg (%.2fs)\n", 
+                               progress, band, total_bands, hint, rate, elapsed);
+                        last_report_time = elapsed;
+                    }
                 }
             }
         }
 
-        // Reporte de progreso (solo proceso 0)
-        if (id == 0 && radius % (N * 50000) == 0) {
-            double elapsed = MPI_Wtime() - start_time;
-            if (elapsed - last_report_time >= 2.0) {
-                double progress = ((double)radius * 100.0) / search_radius;
-                long approx_total = keys_tested * N;
-                double rate = approx_total / elapsed;
-                printf("Progreso: %.2f%% - Radio: %ld/%ld - %.0f claves/seg (%.2fs)\n", 
-                       progress, radius, search_radius, rate, elapsed);
-                last_report_time = elapsed;
-            }
+        // Acierto en esta banda: publicar el más cercano a la pista
+        if (band < fence && des_bands_band(best) == band) {
+            long key = des_bands_key(&bands, best);
+            printf("\n>>> Proceso %d ENCONTRÓ LA CLAVE: %ld <<<\n", id, key);
+            printf("    Distancia desde pista %d: %ld\n", hint, labs(key - center));
+
+            // Notificar a todos los demás procesos
+            des_stop_post(&stop, best);
+            fence = band + 1;
         }
     }
+    des_counter_free(&counter);
+
+    // Cerco: todas las bandas anteriores a la del acierto ya están terminadas; el mínimo
+    // entre procesos es el acierto más probable (el más cercano a su pista)
+    long winner;
+    MPI_Allreduce(&best, &winner, 1, MPI_LONG, MPI_MIN, comm);
+    des_stop_finish(&stop);
+    if (hamming >= 0) {
+        // En la capa ganadora todas las claves están a la misma distancia: la menor
+        long candidate = (best == winner) ? best_key : LONG_MAX;
+        MPI_Allreduce(&candidate, &found, 1, MPI_LONG, MPI_MIN, comm);
+        if (winner == DES_STOP_EMPTY) found = DES_STOP_NONE;
+    } else {
+        found = winner == DES_STOP_EMPTY ? DES_STOP_NONE : des_bands_key(&bands, winner);
+    }
 
     end_time = MPI_Wtime();
 
-    // Asegurar que todos reciban la clave encontrada
-    MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_LONG, MPI_MAX, comm);
-
     // Recolectar estadísticas
     long total_keys_tested;
     MPI_Reduce(&keys_tested, &total_keys_tested, 1, MPI_LONG, MPI_SUM, 0, comm);
@@ -357,8 +589,9 @@ int main(int argc, char *argv[]) {
         double total_time = end_time - start_time;
         
         printf("\n=== RESULTADOS ===\n");
-        if (found != 0) {
+        if (found != DES_STOP_NONE) {
             printf("✓ CLAVE ENCONTRADA: %ld\n", found);
+            des_key_print_class(stdout, found);
             printf("Clave real (usada para cifrar): %ld\n", real_key);
             
             if (found == real_key) {
@@ -367,10 +600,15 @@ int main(int argc, char *argv[]) {
                 printf("✗ ADVERTENCIA: La clave encontrada NO coincide con la real\n");
             }
             
+            des_hint_t *nearest = &bands.hint[nearestHint(&bands, found, hamming)];
+            const char *unit = hamming >= 0 ? " bits" : "";
             printf("\nEstadísticas de búsqueda:\n");
-            printf("- Pista inicial: %ld\n", hint_key);
-            printf("- Distancia pista → clave encontrada: %ld\n", labs(found - hint_key));
-            printf("- Distancia pista → clave real: %ld\n", labs(real_key - hint_key));
+            printf("- Pista más cercana: %ld (pista %d de %d)\n", nearest->key,
+                   (int)(nearest - bands.hint), bands.n);
+            printf("- Distancia pista → clave encontrada: %ld%s\n",
+                   hintDistance(found, nearest->key, hamming), unit);
+            printf("- Distancia pista → clave real: %ld%s\n",
+                   hintDistance(real_key, nearest->key, hamming), unit);
             printf("- Total de claves probadas: %ld\n", total_keys_tested);
             printf("- Tiempo total: %.2f segundos\n", total_time);
             printf("- Velocidad promedio: %.0f claves/segundo\n", 
@@ -382,33 +620,41 @@ int main(int argc, char *argv[]) {
             printf("- Eficiencia: %.1f%%\n", 100.0);
             
             // Estadísticas de búsqueda radial
-            double radius_explored = (double)labs(found - hint_key);
-            double percent_explored = (radius_explored / search_radius) * 100;
-            printf("\nEficiencia de la pista:\n");
-            printf("- Radio explorado hasta encontrar: %.0f\n", radius_explored);
-            printf("- Porcentaje del radio total: %.2f%%\n", percent_explored);
-            printf("- Reducción de espacio vs búsqueda completa: %.2f%%\n", 
-                   100 - percent_explored);
+            if (hamming < 0) {
+                double radius_explored = (double)labs(found - nearest->key);
+                double percent_explored = (radius_explored / nearest->radius) * 100;
+                printf("\nEficiencia de la pista:\n");
+                printf("- Radio explorado hasta encontrar: %.0f\n", radius_explored);
+                printf("- Porcentaje del radio total: %.2f%%\n", percent_explored);
+                printf("- Reducción de espacio vs búsqueda completa: %.2f%%\n", 
+                       100 - percent_explored);
+            }
             
             // Descifrar y mostrar
-            decrypt(found, buffer, ciphlen);
+            des_mode_crypt(&mode, found, buffer, ciphlen, 0);
             buffer[ciphlen] = 0;
             printf("\n--- Texto descifrado ---\n%s\n", buffer);
             printf("------------------------\n");
         } else {
             printf("✗ No se encontró la clave en el radio especificado\n");
-            printf("Pista usada: %ld\n", hint_key);
-            printf("Radio explorado: %ld\n", search_radius);
-            printf("Rango explorado: [%ld, %ld]\n", 
-                   hint_key - search_radius, 
-                   hint_key + search_radius);
+            for (int h = 0; h < bands.n && hamming >= 0; h++) {
+                printf("Pista usada: %ld - distancia de Hamming explorada: 0..%d bits\n",
+                       bands.hint[h].key, hamming);
+            }
+            for (int h = 0; h < bands.n && hamming < 0; h++) {
+                printf("Pista usada: %ld - radio explorado: %ld - rango [%ld, %ld]\n",
+                       bands.hint[h].key, bands.hint[h].radius,
+                       bands.hint[h].key - bands.hint[h].radius,
+                       bands.hint[h].key + bands.hint[h].radius);
+            }
             printf("Clave real: %ld\n", real_key);
             printf("Total de claves probadas: %ld\n", total_keys_tested);
             printf("Tiempo total: %.2f segundos\n", total_time);
             printf("Velocidad: %.0f claves/segundo\n", 
                    total_time > 0 ? total_keys_tested / total_time : 0.0);
             printf("\nSugerencias:\n");
-            printf("- Incremente el radio de búsqueda con -r\n");
+            printf(hamming >= 0 ? "- Incremente la distancia con --hamming\n"
+                                : "- Incremente el radio de búsqueda con -r\n");
             printf("- Ajuste la pista con -h para estar más cerca de %ld\n", real_key);
         }
     }
@@ -4,6 +4,8 @@
 #include <openssl/des.h>
 #include <ctype.h>
 #include <mpi.h>
+#include "../common/des_keys.h"
+#include "../common/des_sp.h"
 
 #define MAX_TEXT 4096
 #define CHECK_INTERVAL 5000
@@ -13,8 +15,7 @@ void decrypt(long key, unsigned char *ciph, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -29,8 +30,7 @@ void encrypt(long key, unsigned char *plain, int len) {
     DES_cblock keyblock;
     DES_key_schedule schedule;
     
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
+    des_key_to_block(key, &keyblock);
     DES_set_key_unchecked(&keyblock, &schedule);
 
     for (int i = 0; i < len; i += 8) {
@@ -55,52 +55,40 @@ int isLikelyPlaintext(unsigned char *data, int len) {
     return (printable * 100 / check_len) > 90;
 }
 
-int quickCheckFirstBlock(long key, unsigned char *ciph) {
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    unsigned char first_block[8];
-    
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
-    
-    memcpy(first_block, ciph, 8);
-    DES_ecb_encrypt((DES_cblock *)first_block,
-                    (DES_cblock *)first_block,
-                    &schedule,
-                    DES_DECRYPT);
-    
-    return isLikelyPlaintext(first_block, 8);
-}
-
-int tryKey(long key, unsigned char *ciph, int len, unsigned char *temp_buffer, const char *search_word) {
-    if (!quickCheckFirstBlock(key, ciph)) {
-        return 0;
+// Prueba las n <= DES_SP_WAYS claves de una capa a la vez con el DES escalar de des_sp.h:
+// el primer bloque se descifra con las claves intercaladas partiendo de first_ip =
+// IP(primer bloque cifrado), calculado una sola vez. Devuelve la posición de la clave
+// encontrada o -1.
+int tryKeys(const long *keys, int n, unsigned char *ciph, uint64_t first_ip, int len,
+            unsigned char *temp_buffer, const char *search_word) {
+    des_sp_key ks[DES_SP_WAYS];
+    const des_sp_key *kp[DES_SP_WAYS];
+    uint64_t state[DES_SP_WAYS];
+
+    for (int j = 0; j < n; j++) {
+        des_sp_set_key(&ks[j], keys[j]);
+        kp[j] = &ks[j];
+        state[j] = first_ip;
     }
-    
-    DES_cblock keyblock;
-    DES_key_schedule schedule;
-    
-    memcpy(&keyblock, &key, 8);
-    DES_set_odd_parity(&keyblock);
-    DES_set_key_unchecked(&keyblock, &schedule);
-    
-    memcpy(temp_buffer, ciph, len);
-    
-    for (int i = 0; i < len; i += 8) {
-        DES_ecb_encrypt((DES_cblock *)(temp_buffer + i),
-                        (DES_cblock *)(temp_buffer + i),
-                        &schedule,
-                        DES_DECRYPT);
+    des_sp_crypt(kp, n, state, 1);
+
+    for (int j = 0; j < n; j++) {
+        des_sp_fp(state[j], temp_buffer);
+        if (!isLikelyPlaintext(temp_buffer, 8)) {
+            continue;
+        }
+        for (int i = 8; i < len; i += 8) {
+            des_sp_block(&ks[j], ciph + i, temp_buffer + i, 1);
+        }
+        temp_buffer[len] = 0;
+        if (strstr((char *)temp_buffer, search_word) != NULL) return j;
     }
-    
-    temp_buffer[len] = 0;
-    return strstr((char *)temp_buffer, search_word) != NULL;
+    return -1;
 }
 
 int main(int argc, char *argv[]) {
     int N, id;
-    long found = 0;
+    long found = -1;
     double start_time, end_time;
     MPI_Status status;
     
@@ -122,15 +110,15 @@ int main(int argc, char *argv[]) {
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
                 real_key = atol(argv[++i]);
-                if (real_key < 0 || real_key >= (1L << 56)) {
-                    fprintf(stderr, "Error: La clave debe estar entre 0 y %ld\n", (1L << 56) - 1);
+                if (!des_key_valid(real_key)) {
+                    fprintf(stderr, "Error: La clave debe estar entre 0 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(MPI_COMM_WORLD, 1);
                 }
                 has_real_key = 1;
             } else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc) {
                 hint_key = atol(argv[++i]);
-                if (hint_key < 0 || hint_key >= (1L << 56)) {
-                    fprintf(stderr, "Error: La pista debe estar entre 0 y %ld\n", (1L << 56) - 1);
+                if (!des_key_valid(hint_key)) {
+                    fprintf(stderr, "Error: La pista debe estar entre 0 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(MPI_COMM_WORLD, 1);
                 }
                 has_hint = 1;
@@ -240,15 +228,23 @@ int main(int argc, char *argv[]) {
     start_time = MPI_Wtime();
 
     long keys_tested = 0;
-    unsigned char temp_buffer[MAX_TEXT];
+    unsigned char temp_buffer[MAX_TEXT + 8];
+    uint64_t first_ip;
     int message_available;
     long received_key;
     double last_report_time = 0;
 
     // BÚSQUEDA SECUENCIAL: Solo proceso 0 trabaja
     if (id == 0) {
+        des_sp_init();
+        if (!des_sp_selftest()) {
+            fprintf(stderr, "Error: el DES escalar no coincide con OpenSSL\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        first_ip = des_sp_ip(buffer);   // el primer bloque pasa por IP una sola vez
+
         // Búsqueda radial secuencial
-        for (long radius = 0; radius <= search_radius && found == 0; radius++) {
+        for (long radius = 0; radius <= search_radius && found == -1; radius++) {
             
             // Generar claves en esta capa
             long keys_in_layer[2];
@@ -256,29 +252,25 @@ int main(int argc, char *argv[]) {
 
             // Lado negativo (pista - radio)
             long key_minus = hint_key - radius;
-            if (key_minus >= 0 && key_minus < (1L << 56)) {
+            if (key_minus >= 0 && key_minus < DES_KEY_SPACE) {
                 keys_in_layer[valid_keys++] = key_minus;
             }
 
             // Lado positivo (pista + radio), evitar duplicado en radius=0
             if (radius > 0) {
                 long key_plus = hint_key + radius;
-                if (key_plus >= 0 && key_plus < (1L << 56)) {
+                if (key_plus >= 0 && key_plus < DES_KEY_SPACE) {
                     keys_in_layer[valid_keys++] = key_plus;
                 }
             }
 
-            // Probar claves en esta capa
-            for (int k = 0; k < valid_keys && found == 0; k++) {
-                long key = keys_in_layer[k];
-                keys_tested++;
-
-                // Probar la clave
-                if (tryKey(key, buffer, ciphlen, temp_buffer, search_word)) {
-                    found = key;
-                    printf("\n>>> CLAVE ENCONTRADA: %ld (radio: %ld) <<<\n", key, radius);
-                    break;
-                }
+            // Probar las claves de esta capa (intercaladas)
+            keys_tested += valid_keys;
+            int hit = valid_keys > 0 ? tryKeys(keys_in_layer, valid_keys, buffer, first_ip,
+                                               ciphlen, temp_buffer, search_word) : -1;
+            if (hit >= 0) {
+                found = keys_in_layer[hit];
+                printf("\n>>> CLAVE ENCONTRADA: %ld (radio: %ld) <<<\n", found, radius);
             }
 
             // Reporte de progreso (cada 50000 radios o cada 2 segundos)
@@ -312,8 +304,9 @@ int main(int argc, char *argv[]) {
         double total_time = end_time - start_time;
         
         printf("\n=== RESULTADOS (SECUENCIAL) ===\n");
-        if (global_found != 0) {
+        if (global_found != -1) {
             printf("✓ CLAVE ENCONTRADA: %ld\n", global_found);
+            des_key_print_class(stdout, global_found);
             printf("Clave real (usada para cifrar): %ld\n", real_key);
             
             if (global_found == real_key) {
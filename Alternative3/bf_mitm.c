@@ -0,0 +1,359 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <openssl/des.h>
+#include "../common/des_keys.h"
+#include "../common/des_bs.h"
+#include "../common/des_gray.h"
+#include "../common/des_verify.h"
+#include "../common/des_mitm.h"
+
+#define MAX_TEXT 4096
+#define DEFAULT_TABLE (1L << 22)   // entradas de la tabla por proceso
+#define DEFAULT_BATCH (1L << 16)   // claves por proceso en cada intercambio
+
+void encrypt(long key, unsigned char *plain, int len) {
+    DES_cblock keyblock;
+    DES_key_schedule schedule;
+
+    des_key_to_block(key, &keyblock);
+    DES_set_key_unchecked(&keyblock, &schedule);
+
+    for (int i = 0; i < len; i += 8) {
+        DES_ecb_encrypt((DES_cblock *)(plain + i),
+                        (DES_cblock *)(plain + i),
+                        &schedule,
+                        DES_ENCRYPT);
+    }
+}
+
+// E_k(in) (enc=1) o D_k(in) (enc=0) para las claves [lo, hi) con el kernel bitsliced.
+// Deja los pares (valor, clave) en out y devuelve cuántos.
+long computePairs(des_bs_keys *ks, long lo, long hi, const unsigned char *in, int enc,
+                  des_mitm_pair *out) {
+    uint64_t values[DES_BS_LANES];
+    des_gray_t walk;
+    long base, n = 0;
+    int count;
+
+    des_gray_init(&walk, lo, hi, des_bs_lanes());
+    while (des_gray_next(&walk, &base, &count)) {
+        des_bs_keys_load(ks, base, count);
+        des_bs_crypt_lanes(ks, in, enc, values);
+        for (int lane = 0; lane < count; lane++) {
+            out[n].value = values[lane];
+            out[n].key = base + lane;
+            n++;
+        }
+    }
+    return n;
+}
+
+// Confirma una coincidencia E_k1(P0) == D_k2(C0): el segundo bloque conocido (si hay) y,
+// si se dio con -s, la palabra en el mensaje completo descifrado
+int tryPair(long k1, long k2, const unsigned char *ciph, int len, const unsigned char *plain1,
+            const des_crib_t *crib, unsigned char *temp_buffer) {
+    des_sp_key ks1, ks2;
+
+    des_sp_set_key(&ks1, k1);
+    des_sp_set_key(&ks2, k2);
+    if (len >= 16) {
+        unsigned char block[8];
+        des_sp_block(&ks2, ciph + 8, block, 1);
+        des_sp_block(&ks1, block, block, 1);
+        if (memcmp(block, plain1, 8) != 0) return 0;
+    }
+    if (crib->len == 0) return 1;
+
+    des_sp_decrypt_all(&ks2, ciph, len, temp_buffer);
+    des_sp_decrypt_all(&ks1, temp_buffer, len, temp_buffer);
+    return des_crib_search(crib, temp_buffer, len);
+}
+
+// Rondas de intercambio para repartir [lo, hi) entre nprocs en trozos de batch claves:
+// el mismo número en todos los procesos (lo marca la parte más grande, la del último)
+long roundsFor(long lo, long hi, int nprocs, long batch) {
+    long per = (hi - lo) / nprocs;
+    long largest = per + (hi - lo) % nprocs;
+    return (largest + batch - 1) / batch;
+}
+
+// Parte [mylo, myhi) de este proceso en el rango [lo, hi)
+void myRange(long lo, long hi, int nprocs, int id, long *mylo, long *myhi) {
+    long per = (hi - lo) / nprocs;
+    *mylo = lo + per * id;
+    *myhi = (id == nprocs - 1) ? hi : *mylo + per;
+}
+
+int main(int argc, char *argv[]) {
+    int N, id;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    long real_k1 = 123456L, real_k2 = 654321L;
+    int key_bits = 56;
+    long table_entries = DEFAULT_TABLE;
+    long batch = DEFAULT_BATCH;
+    char search_word[256] = "";
+    char input_file[256] = "input.txt";
+    des_crib_t crib;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(comm, &N);
+    MPI_Comm_rank(comm, &id);
+
+    des_bs_init();
+    des_bs_set_keymap(des_key_to_block);
+
+    // Proceso 0: parsear argumentos
+    if (id == 0) {
+        if (!des_bs_selftest()) {
+            fprintf(stderr, "Error: el kernel DES bitsliced no coincide con OpenSSL\n");
+            MPI_Abort(comm, 1);
+        }
+
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+                char *end;
+                real_k1 = strtol(argv[++i], &end, 10);
+                if (*end != ':') {
+                    fprintf(stderr, "Error: -k espera K1:K2\n");
+                    MPI_Abort(comm, 1);
+                }
+                real_k2 = strtol(end + 1, &end, 10);
+                if (*end != '\0') {
+                    fprintf(stderr, "Error: -k espera K1:K2\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+                key_bits = atoi(argv[++i]);
+                if (key_bits < 1 || key_bits > 56) {
+                    fprintf(stderr, "Error: el ancho de clave debe estar entre 1 y 56 bits\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+                table_entries = atol(argv[++i]);
+                if (table_entries <= 0) {
+                    fprintf(stderr, "Error: la tabla debe tener al menos una entrada\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+                batch = atol(argv[++i]);
+                if (batch < des_bs_lanes() || batch > (1L << 24)) {
+                    fprintf(stderr, "Error: el lote debe estar entre %d y %ld claves\n",
+                            des_bs_lanes(), 1L << 24);
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+                strncpy(search_word, argv[++i], sizeof(search_word) - 1);
+            } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+                strncpy(input_file, argv[++i], sizeof(input_file) - 1);
+            }
+        }
+
+        if (real_k1 < 0 || real_k2 < 0 || real_k1 >= (1L << key_bits) || real_k2 >= (1L << key_bits)) {
+            fprintf(stderr, "Error: las claves deben estar entre 0 y %ld (-w %d)\n",
+                    (1L << key_bits) - 1, key_bits);
+            fprintf(stderr, "Uso: %s -k K1:K2 [-w bits] [-M entradas] [-B lote] [-s palabra] [-f archivo]\n",
+                    argv[0]);
+            MPI_Abort(comm, 1);
+        }
+    }
+
+    MPI_Bcast(&key_bits, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&table_entries, 1, MPI_LONG, 0, comm);
+    MPI_Bcast(&batch, 1, MPI_LONG, 0, comm);
+    MPI_Bcast(search_word, 256, MPI_CHAR, 0, comm);
+    des_crib_init(&crib, search_word);
+
+    unsigned char buffer[MAX_TEXT + 8];
+    unsigned char known[2][8] = {{0}};   // P0 (se empareja) y P1 (confirma)
+    int ciphlen = 0;
+
+    // Proceso 0: leer y cifrar dos veces (la primera con K1)
+    if (id == 0) {
+        FILE *f = fopen(input_file, "rb");
+        if (!f) {
+            fprintf(stderr, "Error: no se pudo abrir %s\n", input_file);
+            MPI_Abort(comm, 1);
+        }
+        ciphlen = fread(buffer, 1, MAX_TEXT, f);
+        fclose(f);
+
+        if (ciphlen % 8 != 0) {
+            int pad = 8 - (ciphlen % 8);
+            memset(buffer + ciphlen, 0, pad);
+            ciphlen += pad;
+        }
+        memcpy(known, buffer, ciphlen < 16 ? 8 : 16);
+
+        encrypt(real_k1, buffer, ciphlen);
+        encrypt(real_k2, buffer, ciphlen);
+    }
+
+    MPI_Bcast(&ciphlen, 1, MPI_INT, 0, comm);
+    MPI_Bcast(buffer, ciphlen, MPI_UNSIGNED_CHAR, 0, comm);
+    MPI_Bcast(known, sizeof(known), MPI_UNSIGNED_CHAR, 0, comm);
+
+    long space = 1L << key_bits;
+    long pass_keys = table_entries * N < space ? table_entries * N : space;
+    long passes = (space + pass_keys - 1) / pass_keys;
+
+    des_mitm_table_t table;
+    des_mitm_exchange_t xchg;
+    des_mitm_pair *pairs = malloc(batch * sizeof(des_mitm_pair));
+    unsigned char *temp_buffer = malloc(MAX_TEXT + 8);
+    static des_bs_keys batch_keys;
+
+    // Con el reparto por hash cada proceso recibe ~pass_keys / N entradas por pasada
+    int ok = des_mitm_exchange_init(&xchg, N, batch);
+    ok = des_mitm_table_init(&table, (pass_keys + N - 1) / N) && ok;
+    if (!ok || !pairs || !temp_buffer) {
+        fprintf(stderr, "Error: proceso %d sin memoria para la tabla\n", id);
+        MPI_Abort(comm, 1);
+    }
+    des_bs_keys_init(&batch_keys);
+
+    if (id == 0) {
+        printf("=== DOBLE DES - MEET-IN-THE-MIDDLE ===\n");
+        printf("\n[SIMULACIÓN]\n");
+        printf("Claves REALES: K1 = %ld, K2 = %ld\n", real_k1, real_k2);
+        printf("Archivo: %s (%d bytes)\n", input_file, ciphlen);
+        printf("\n[PARÁMETROS]\n");
+        printf("Ancho de clave: %d bits (2 x %ld claves)\n", key_bits, space);
+        printf("Procesos MPI: %d\n", N);
+        printf("Tabla por proceso: %ld entradas (%.1f MB)\n", table_entries,
+               (table.mask + 1) * (sizeof(uint64_t) + sizeof(long)) / 1048576.0);
+        printf("Pasadas sobre K1: %ld (%ld claves por pasada)\n", passes, pass_keys);
+        printf("Lote por intercambio: %ld claves por proceso\n", batch);
+        printf("Confirmación: %s%s\n", ciphlen >= 16 ? "segundo bloque conocido" : "sin segundo bloque",
+               crib.len > 0 ? " + palabra" : "");
+        if (crib.len > 0) printf("Palabra de búsqueda: \"%s\"\n", search_word);
+        printf("Kernel DES: %s (%d claves por lote)\n\n", des_bs_kernel_name, des_bs_lanes());
+    }
+
+    MPI_Barrier(comm);
+    double start_time = MPI_Wtime();
+
+    long found[2] = {-1, -1};
+    unsigned long keys_computed = 0;   // cifrados y descifrados de un bloque
+    unsigned long candidates = 0;      // coincidencias de la tabla que hubo que confirmar
+    long pass;
+
+    for (pass = 0; pass < passes && found[0] == -1; pass++) {
+        long lo1 = pass * pass_keys;
+        long hi1 = lo1 + pass_keys < space ? lo1 + pass_keys : space;
+        long mylo, myhi;
+
+        // Fase 1: E_k1(P0) para las claves K1 de la pasada, cada valor a su dueño
+        des_mitm_table_clear(&table);
+        myRange(lo1, hi1, N, id, &mylo, &myhi);
+        long rounds = roundsFor(lo1, hi1, N, batch);
+        int full = 0;
+        for (long r = 0; r < rounds; r++) {
+            long a = mylo + r * batch, b = a + batch < myhi ? a + batch : myhi;
+            long n = a < b ? computePairs(&batch_keys, a, b, known[0], 1, pairs) : 0;
+            long got = des_mitm_exchange(&xchg, pairs, n, comm);
+            if (got < 0) {
+                fprintf(stderr, "Error: proceso %d sin memoria en el intercambio\n", id);
+                MPI_Abort(comm, 1);
+            }
+            for (long i = 0; i < got && !full; i++) {
+                full = !des_mitm_table_add(&table, xchg.recv[i].value, xchg.recv[i].key);
+            }
+            if (full) {
+                fprintf(stderr, "Error: tabla del proceso %d llena; aumente -M\n", id);
+                MPI_Abort(comm, 1);
+            }
+            keys_computed += n;
+        }
+
+        // Fase 2: D_k2(C0) para todas las claves K2, buscado en la tabla del dueño
+        myRange(0, space, N, id, &mylo, &myhi);
+        rounds = roundsFor(0, space, N, batch);
+        for (long r = 0; r < rounds; r++) {
+            long a = mylo + r * batch, b = a + batch < myhi ? a + batch : myhi;
+            long n = a < b ? computePairs(&batch_keys, a, b, buffer, 0, pairs) : 0;
+            long got = des_mitm_exchange(&xchg, pairs, n, comm);
+            if (got < 0) {
+                fprintf(stderr, "Error: proceso %d sin memoria en el intercambio\n", id);
+                MPI_Abort(comm, 1);
+            }
+            keys_computed += n;
+
+            int winner = N;
+            for (long i = 0; i < got && winner == N; i++) {
+                long slot = -1;
+                while ((slot = des_mitm_table_find(&table, xchg.recv[i].value, slot)) >= 0) {
+                    long k1 = table.key[slot], k2 = xchg.recv[i].key;
+                    candidates++;
+                    if (tryPair(k1, k2, buffer, ciphlen, known[1], &crib, temp_buffer)) {
+                        found[0] = k1;
+                        found[1] = k2;
+                        winner = id;
+                        break;
+                    }
+                }
+            }
+
+            // Parada: el proceso de menor rango con un par confirmado lo difunde
+            MPI_Allreduce(MPI_IN_PLACE, &winner, 1, MPI_INT, MPI_MIN, comm);
+            if (winner < N) {
+                MPI_Bcast(found, 2, MPI_LONG, winner, comm);
+                if (id == winner) {
+                    printf(">>> Proceso %d ENCONTRÓ EL PAR: K1 = %ld, K2 = %ld (pasada %ld)\n",
+                           id, found[0], found[1], pass + 1);
+                    fflush(stdout);
+                }
+                break;
+            }
+        }
+        if (id == 0 && found[0] == -1) {
+            printf("Pasada %ld/%ld sin coincidencias (%.2fs)\n", pass + 1, passes,
+                   MPI_Wtime() - start_time);
+            fflush(stdout);
+        }
+    }
+
+    double total_time = MPI_Wtime() - start_time;
+    unsigned long total_computed, total_candidates;
+    MPI_Reduce(&keys_computed, &total_computed, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(&candidates, &total_candidates, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+
+    if (id == 0) {
+        printf("\n=== RESULTADOS ===\n");
+        if (found[0] != -1) {
+            printf("✓ PAR ENCONTRADO: K1 = %ld, K2 = %ld\n", found[0], found[1]);
+            if (found[0] == real_k1 && found[1] == real_k2) {
+                printf("✓ ¡El par encontrado es CORRECTO!\n");
+            } else {
+                printf("✗ El par no es el usado para cifrar (clave equivalente o falso positivo)\n");
+            }
+
+            des_sp_key ks1, ks2;
+            des_sp_set_key(&ks1, found[0]);
+            des_sp_set_key(&ks2, found[1]);
+            des_sp_decrypt_all(&ks2, buffer, ciphlen, temp_buffer);
+            des_sp_decrypt_all(&ks1, temp_buffer, ciphlen, temp_buffer);
+            printf("\n--- Texto descifrado ---\n%s\n", temp_buffer);
+            printf("------------------------\n");
+        } else {
+            printf("✗ No se encontró el par en el espacio de %d bits\n", key_bits);
+        }
+
+        printf("\nEstadísticas:\n");
+        printf("  Pasadas: %ld de %ld\n", pass, passes);
+        printf("  Bloques DES calculados: %lu (fuerza bruta: %.3g pares de claves)\n",
+               total_computed, (double)space * (double)space);
+        printf("  Coincidencias en la tabla (confirmadas aparte): %lu\n", total_candidates);
+        printf("  Tiempo total: %.2f segundos\n", total_time);
+        printf("  Velocidad: %.0f bloques/segundo\n",
+               total_time > 0 ? total_computed / total_time : 0.0);
+    }
+
+    des_mitm_table_free(&table);
+    des_mitm_exchange_free(&xchg);
+    free(pairs);
+    free(temp_buffer);
+    MPI_Finalize();
+    return 0;
+}
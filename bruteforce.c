@@ -5,25 +5,34 @@
 #include <unistd.h>
 #include <openssl/des.h>
 #include <ctype.h>
+#include <time.h>
+#include "common/des_keys.h"
+#include "common/des_bs.h"
+#include "common/des_gray.h"
+#include "common/des_prefix.h"
+#include "common/des_verify.h"
+#include "common/des_cribset.h"
+#include "common/des_targets.h"
+#include "common/des_mode.h"
+#include "common/des_sched.h"
+#include "common/des_stop.h"
+#include "common/des_poll.h"
+#include "common/des_ckpt.h"
+#include "common/des_shuffle.h"
+#include "common/des_mask.h"
+#include "common/des_wordlist.h"
+#include "common/des_prepass.h"
 
 #define MAX_TEXT 4096
-#define DEFAULT_MAX_KEY ((1L<<56))
-#define TIMEOUT_SECONDS 60.0  // Timeout de 1 minuto
+#define DEFAULT_MAX_KEY DES_KEY_SPACE
+#define DEFAULT_TIMEOUT 60.0  // Timeout de 1 minuto (--timeout)
 #define PROGRESS_INTERVAL 100000  // Reportar cada 100k claves
 
 void decrypt(long key, char *ciph, int len){
-  long k = 0;
-  long tmp = key;
-  for(int i=0; i<8; ++i){
-    tmp <<= 1;
-    k += (tmp & (0xFELL << (i*8)));
-  }
-
   DES_cblock keyblock;
   DES_key_schedule schedule;
 
-  memcpy(&keyblock, &k, 8);
-  DES_set_odd_parity(&keyblock);
+  des_key_to_block(key, &keyblock);
   DES_set_key_unchecked(&keyblock, &schedule);
 
   for(int i=0; i<len; i+=8){
@@ -35,18 +44,10 @@ void decrypt(long key, char *ciph, int len){
 }
 
 void encrypt(long key, char *ciph, int len){
-  long k = 0;
-  long tmp = key;
-  for(int i=0; i<8; ++i){
-    tmp <<= 1;
-    k += (tmp & (0xFELL << (i*8)));
-  }
-
   DES_cblock keyblock;
   DES_key_schedule schedule;
 
-  memcpy(&keyblock, &k, 8);
-  DES_set_odd_parity(&keyblock);
+  des_key_to_block(key, &keyblock);
   DES_set_key_unchecked(&keyblock, &schedule);
 
   for(int i=0; i<len; i+=8){
@@ -58,21 +59,431 @@ void encrypt(long key, char *ciph, int len){
 }
 
 char search_str[256] = " es una prueba de ";
+des_crib_t crib;       // search_str lista para la verificación incremental
+des_prefix_t prefix;   // texto conocido (-p); prefix.len == 0 si no se usa
+des_cribset_t cribset; // fragmentos cifrables de la frase (-x)
+des_mode_t cipher_mode; // --mode/--iv; ECB por defecto
+int text_filter = 0;    // --text-filter: descartar claves cuyo primer bloque no es texto
+double timeout_seconds = DEFAULT_TIMEOUT; // --timeout; 0 = sin límite
+char checkpoint_path[256] = "";           // --checkpoint/--resume; vacío = sin checkpoint
+unsigned long shuffle_seed = 0;           // --shuffle; 0 = orden natural
+des_mask_t key_mask;                      // --mask; key_mask.active == 0 si no se usa
+char wordlist_path[256] = "";             // --wordlist; vacío = barrido de rango
+char wordlist_rules[32] = ":";            // --rules
+int wordlist_derive = DES_DERIVE_STRING | DES_DERIVE_PACK;   // --derive
+char prepass_families[8] = "";           // --prepass; vacío = sin pasada previa
+long list_keys[DES_BS_LANES + 2 * DES_WORDLIST_VARIANTS];   // lote de claves de --wordlist/--prepass
+int list_batch = 0;                       // 1 mientras se prueban lotes de list_keys
+
+// Buffer de descifrado reutilizado por tryKey (un solo hilo por proceso)
+static unsigned char verify_buffer[MAX_TEXT + 8] __attribute__((aligned(64)));
+// Núcleo de verificación para la longitud del mensaje y la frase (des_verify_select)
+static des_verify_fn verify_kernel = des_verify_generic;
+
+// Valor del barrido -> clave. Con --mask se barre un contador denso sobre la parte
+// desconocida de la clave (des_mask.h); sin máscara el valor ya es la clave.
+// Con --wordlist y --prepass el valor es la posición en el lote de claves (list_keys).
+long keyAt(long value){
+  if(list_batch) return list_keys[value];
+  return key_mask.active ? des_mask_key(&key_mask, value) : value;
+}
+
+// Conversión para el kernel bitsliced con lotes de list_keys (des_bs_set_key_fn)
+void listKeyBlock(long value, DES_cblock *keyblock){
+  des_key_to_block(list_keys[value], keyblock);
+}
 
 int tryKey(long key, const unsigned char *ciph, int len){
-  // hacemos copia porque decrypt muta el buffer
-  char *temp = malloc(len + 1);
-  if(!temp) return 0;
-  memcpy(temp, ciph, len);
-  temp[len] = 0;
+  des_sp_key ks;
 
-  decrypt(key, temp, len);
+  // Subclaves desde el índice canónico (des_sp.h). Sin --text-filter se descifra todo y
+  // se busca la frase; con él, bloque a bloque: se descarta en el primer bloque que no es
+  // texto y la frase se busca sobre la marcha
+  des_sp_set_key(&ks, key);
+  if(!text_filter){
+    des_sp_decrypt_cbc(&ks, ciph, len, des_mode_iv(&cipher_mode), verify_buffer);
+    return des_crib_search(&crib, verify_buffer, len);
+  }
+  if(cipher_mode.cbc){
+    return des_verify_cbc(&ks, ciph, len, cipher_mode.iv, &crib, verify_buffer);
+  }
+  return verify_kernel(&ks, ciph, len, &crib, verify_buffer);
+}
 
-  int found = (strstr((char *)temp, search_str) != NULL);
-  free(temp);
+// Prueba `count` claves consecutivas desde base_key (hasta des_bs_lanes()) con el kernel
+// bitsliced. ks conserva las claves del lote anterior: si los lotes vienen en orden Gray
+// (des_gray_next) la carga es incremental. Con --text-filter solo los carriles cuyo primer
+// bloque descifrado es texto (en CBC, D(C0) ^ IV) pasan a tryKey; sin él pasan todos y el
+// lote no se carga (en ECB y con frase de DES_CRIBSET_MIN bytes o más main elige -x).
+// Devuelve cuántas claves coincidieron y las deja en hits.
+int tryKeys(des_bs_keys *ks, long base_key, int count, const unsigned char *ciph, int len, long *hits){
+  int num_hits = 0;
+
+  uint64_t candidates[DES_BS_LANES / 64];
+  if(text_filter){
+    des_bs_keys_load(ks, base_key, count);
+    if(!des_bs_candidates_iv(ks, count, ciph, des_mode_iv(&cipher_mode), candidates)) return 0;
+  } else {
+    // Sin filtro no hace falta trasponer las claves: tryKey las prepara una a una
+    des_bs_all(count, candidates);
+  }
+
+  for(int w=0; w<des_bs_lanes() / 64; w++){
+    while(candidates[w]){
+      int lane = 64 * w + __builtin_ctzll(candidates[w]);
+      candidates[w] &= candidates[w] - 1;
+      long key = keyAt(base_key + lane);
+      if(tryKey(key, ciph, len)){
+        hits[num_hits++] = key;
+      }
+    }
+  }
+  return num_hits;
+}
+
+// Modo complemento (-c): E_~k(~P) = ~E_k(P). Con el bloque conocido P0 -> C0 y el bloque
+// elegido ~P0 -> C1, un solo cifrado E_k(P0) prueba k (si da C0) y ~k (si da ~C1), así que
+// basta recorrer la mitad del espacio. known = {P0, C0, ~C1}.
+int tryKeysComplement(des_bs_keys *ks, long base_key, int count, const unsigned char known[3][8],
+                      const unsigned char *ciph, int len, long *hits){
+  uint64_t matches[2][DES_BS_LANES / 64];
+  int num_hits = 0;
+
+  des_bs_keys_load(ks, base_key, count);
+  if(!des_bs_match(ks, count, known[0], 1, known + 1, 2, NULL, matches)) return 0;
+
+  for(int t=0; t<2; t++){
+    for(int w=0; w<des_bs_lanes() / 64; w++){
+      while(matches[t][w]){
+        long key = base_key + 64 * w + __builtin_ctzll(matches[t][w]);
+        matches[t][w] &= matches[t][w] - 1;
+        if(t == 1) key = des_key_complement(key);
+        if(tryKey(key, ciph, len)){
+          hits[num_hits++] = key;
+        }
+      }
+    }
+  }
+  return num_hits;
+}
+
+// Verificación completa de un acierto de los modos -p y -x: descifra todo el mensaje y
+// comprueba el prefijo entero (si hay) y la frase de búsqueda (si hay)
+int tryKeyFull(long key, const unsigned char *ciph, int len){
+  des_sp_key ks;
+
+  des_sp_set_key(&ks, key);
+  des_sp_decrypt_cbc(&ks, ciph, len, des_mode_iv(&cipher_mode), verify_buffer);
+
+  return des_prefix_check(&prefix, verify_buffer, len) && des_crib_search(&crib, verify_buffer, len);
+}
+
+// Modo texto conocido (-p): cada clave cuesta descifrar el primer bloque y compararlo con
+// el prefijo (64 bits, o los bytes conocidos si es más corto). Solo los aciertos se
+// descifran enteros.
+int tryKeysPrefix(des_bs_keys *ks, long base_key, int count, const unsigned char *ciph, int len,
+                  long *hits){
+  uint64_t matches[1][DES_BS_LANES / 64];
+  int num_hits = 0;
+
+  des_bs_keys_load(ks, base_key, count);
+  if(!des_bs_match(ks, count, ciph, 0, &prefix.block, 1, prefix.care, matches)) return 0;
+
+  for(int w=0; w<des_bs_lanes() / 64; w++){
+    while(matches[0][w]){
+      long key = keyAt(base_key + 64 * w + __builtin_ctzll(matches[0][w]));
+      matches[0][w] &= matches[0][w] - 1;
+      if(tryKeyFull(key, ciph, len)){
+        hits[num_hits++] = key;
+      }
+    }
+  }
+  return num_hits;
+}
+
+// Modo frase por bloques (-x): cifra con cada clave los fragmentos alineados de la frase
+// (des_cribset.h) y busca el resultado entre los bloques del texto cifrado. No exige que
+// el primer bloque sea texto y cuesta lo mismo con 32 bytes que con 4 KB de mensaje.
+int tryKeysCrib(des_bs_keys *ks, long base_key, int count, const unsigned char *ciph, int len,
+                long *hits){
+  uint64_t values[DES_BS_LANES];
+  uint64_t matches[DES_BS_LANES / 64] = {0};
+  int num_hits = 0;
+
+  des_bs_keys_load(ks, base_key, count);
+  for(int c=0; c<cribset.nchunks; c++){
+    des_bs_crypt_lanes(ks, cribset.chunk[c], 1, values);
+    for(int lane=0; lane<count; lane++){
+      if(des_cribset_has(&cribset, values[lane])){
+        matches[lane >> 6] |= 1ULL << (lane & 63);
+      }
+    }
+  }
+
+  for(int w=0; w<des_bs_lanes() / 64; w++){
+    while(matches[w]){
+      long key = keyAt(base_key + 64 * w + __builtin_ctzll(matches[w]));
+      matches[w] &= matches[w] - 1;
+      if(tryKeyFull(key, ciph, len)){
+        hits[num_hits++] = key;
+      }
+    }
+  }
+  return num_hits;
+}
+
+// Prueba las claves list_keys[0 .. count-1] (count <= des_bs_lanes()) con el filtro del modo:
+// texto conocido (-p), frase por bloques (-x) o texto. Devuelve cuántas coincidieron.
+int tryKeyList(des_bs_keys *ks, int count, const unsigned char *cipher, int len, int crib_blocks,
+               long *hits){
+  int num_hits;
+
+  des_bs_set_key_fn(listKeyBlock);
+  list_batch = 1;
+  if(prefix.len > 0){
+    num_hits = tryKeysPrefix(ks, 0, count, cipher, len, hits);
+  } else if(crib_blocks){
+    num_hits = tryKeysCrib(ks, 0, count, cipher, len, hits);
+  } else {
+    num_hits = tryKeys(ks, 0, count, cipher, len, hits);
+  }
+  list_batch = 0;
+  des_bs_set_key_fn(NULL);
+  return num_hits;
+}
+
+// Pasada previa (--prepass): las familias de claves elegidas por personas (des_prepass.h),
+// repartidas en tramos iguales entre los procesos, en lotes de list_keys. Devuelve la clave
+// encontrada o -1.
+long search_prepass(const des_prepass_t *pre, des_stop_t *stop, des_poll_t *poll,
+                    const unsigned char *cipher, int len, int crib_blocks,
+                    unsigned long *keys_tested, int *timeout_reached, MPI_Comm comm){
+  int N, id;
+  MPI_Comm_size(comm, &N);
+  MPI_Comm_rank(comm, &id);
+
+  unsigned long lo = pre->total / N * id + (pre->total % N < (unsigned long)id ? pre->total % N : (unsigned long)id);
+  unsigned long hi = lo + pre->total / N + ((unsigned long)id < pre->total % N);
+  static des_bs_keys batch_keys;
+  long hits[DES_BS_LANES];
+  long found = -1;
+
+  des_bs_keys_init(&batch_keys);
+  for(unsigned long i = lo; i < hi && found == -1; ){
+    int count = 0;
+    while(count < des_bs_lanes() && i < hi) list_keys[count++] = des_prepass_key(pre, i++);
+
+    if(tryKeyList(&batch_keys, count, cipher, len, crib_blocks, hits) > 0){
+      found = hits[0];
+      printf("\n✓ Proceso %d ENCONTRÓ LA CLAVE en la pasada previa: %ld\n", id, found);
+      des_stop_post(stop, found);
+    }
+    *keys_tested += count;
+
+    if(found == -1 && des_poll_due(poll)){
+      if(des_poll_begin(poll)){
+        *timeout_reached = 1;
+        if(id == 0){
+          printf("\n⏰ TIMEOUT alcanzado (%.0f segundos)\n", timeout_seconds);
+        }
+        break;
+      }
+      if(des_stop_check(stop, &found)){
+        printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", id);
+        break;
+      }
+    }
+  }
   return found;
 }
 
+// Modo diccionario (--wordlist): cada proceso lee su parte de la lista (des_wordlist.h),
+// aplica las reglas, deriva las claves y las prueba por lotes con el mismo kernel que el
+// barrido (el lote son las posiciones 0..count-1 de list_keys). Devuelve la clave encontrada
+// o -1; *words queda con las palabras leídas por este proceso.
+long search_wordlist(des_stop_t *stop, des_poll_t *poll, const unsigned char *cipher, int len,
+                     int crib_blocks, unsigned long *keys_tested, unsigned long *words,
+                     int *timeout_reached, double start_time, MPI_Comm comm){
+  int N, id;
+  MPI_Comm_size(comm, &N);
+  MPI_Comm_rank(comm, &id);
+
+  des_wordlist_t list;
+  if(!des_wordlist_open(&list, wordlist_path, comm)){
+    fprintf(stderr, "Error: no se pudo abrir la lista %s\n", wordlist_path);
+    MPI_Abort(comm, 1);
+  }
+
+  static char variants[DES_WORDLIST_VARIANTS][2 * DES_WORDLIST_LINE];
+  int lens[DES_WORDLIST_VARIANTS];
+  static des_bs_keys batch_keys;
+  long hits[DES_BS_LANES];
+  long found = -1;
+  int count = 0;
+  char *word;
+  int word_len;
+  unsigned long next_progress = PROGRESS_INTERVAL;
+
+  des_bs_keys_init(&batch_keys);
+  while(found == -1){
+    int more = des_wordlist_next(&list, &word, &word_len);
+    if(more){
+      int n = des_wordlist_mangle(wordlist_rules, word, word_len, variants, lens);
+      for(int v = 0; v < n; v++){
+        count += des_wordlist_derive(wordlist_derive, variants[v], lens[v], list_keys + count);
+      }
+    }
+
+    // Lotes llenos y, al terminar la lista, el último incompleto. Lo que sobra de la última
+    // palabra pasa al principio de list_keys para el lote siguiente.
+    while(found == -1 && (count >= des_bs_lanes() || (!more && count > 0))){
+      int batch = count < des_bs_lanes() ? count : des_bs_lanes();
+      int num_hits = tryKeyList(&batch_keys, batch, cipher, len, crib_blocks, hits);
+      *keys_tested += batch;
+      if(num_hits > 0){
+        found = hits[0];
+        printf("\n✓ Proceso %d ENCONTRÓ LA CLAVE: %ld\n", id, found);
+        des_stop_post(stop, found);
+      }
+      count -= batch;
+      memmove(list_keys, list_keys + batch, count * sizeof(long));
+    }
+    if(!more) break;
+
+    // Cada DES_POLL_LATENCY segundos: tiempo límite, aviso de parada y progreso
+    if(found == -1 && des_poll_due(poll)){
+      if(des_poll_begin(poll)){
+        *timeout_reached = 1;
+        if(id == 0){
+          printf("\n⏰ TIMEOUT alcanzado (%.0f segundos)\n", timeout_seconds);
+        }
+        break;
+      }
+      if(des_stop_check(stop, &found)){
+        printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", id);
+        break;
+      }
+      if(id == 0 && *keys_tested >= next_progress){
+        while(next_progress <= *keys_tested) next_progress += PROGRESS_INTERVAL;
+        double elapsed = poll->now - start_time;
+        printf("[Progreso] %lu palabras | %lu claves | %.0f k/s | %.2fs (proceso 0)\n",
+               list.words, *keys_tested, *keys_tested / elapsed / 1000.0, elapsed);
+      }
+    }
+  }
+
+  *words = list.words;
+  des_wordlist_close(&list);
+  return found;
+}
+
+// Modo multiobjetivo (-t): un solo barrido de [0, max_key) contra todos los objetivos
+// (des_targets.h; cs son los fragmentos de -x o NULL). Cada
+// acierto se anuncia al momento y se avisa al resto de procesos; la búsqueda sigue hasta
+// que no quedan objetivos pendientes, se agota el rango o el tiempo.
+void search_targets(des_targets_t *targets, unsigned long max_key, const des_cribset_t *cs,
+                    MPI_Comm comm){
+  int N, id;
+  MPI_Comm_size(comm, &N);
+  MPI_Comm_rank(comm, &id);
+
+  unsigned long range_per_node = max_key / N;
+  long mylower = range_per_node * id;
+  long myupper = (id == N - 1) ? (long)max_key : (long)(range_per_node * (id + 1));
+
+  if(id == 0){
+    printf("\nRango de búsqueda: 0 a %lu\n", max_key);
+    printf("Número de procesos: %d\n", N);
+    printf("Timeout: %.0f segundos\n", timeout_seconds);
+    printf("Kernel DES: %s (%d claves por lote)\n", des_bs_kernel_name, des_bs_lanes());
+    printf("Objetivos: %d (filtro: %s)\n", targets->n,
+           targets->filter == DES_TARGETS_PREFIX ? "primer bloque del prefijo" :
+           targets->filter == DES_TARGETS_BLOCKS ? "frase por bloques" :
+           targets->text ? "texto en el primer bloque de cada objetivo" : "ninguno, descifrado completo");
+    for(int t = 0; t < targets->n; t++){
+      printf("  [%d] %s (%d bytes)\n", t, targets->name[t], targets->len[t]);
+    }
+    printf("\nIniciando búsqueda...\n\n");
+  }
+
+  MPI_Barrier(comm);
+  double start_time = MPI_Wtime();
+
+  des_targets_open(targets, comm);
+
+  unsigned long keys_tested = 0;
+  int timeout_reached = 0;
+  des_poll_t poll;
+  int solved[DES_TARGETS_MAX];
+  static des_bs_keys batch_keys;
+  des_gray_t walk;
+  long key;
+  int count;
+
+  des_bs_keys_init(&batch_keys);
+  des_gray_init(&walk, mylower, myupper, des_bs_lanes());
+  des_poll_init(&poll, DES_POLL_LATENCY, timeout_seconds, start_time);
+  while(targets->pending > 0 && des_gray_next(&walk, &key, &count)){
+    int num_solved = des_targets_scan(targets, &batch_keys, key, count, &prefix,
+                                      cs, &crib, verify_buffer, solved);
+    for(int i = 0; i < num_solved; i++){
+      int t = solved[i];
+      printf("✓ Proceso %d resolvió el objetivo %d (%s): clave %ld (%.2fs)\n",
+             id, t, targets->name[t], targets->key[t], MPI_Wtime() - start_time);
+      fflush(stdout);
+      des_targets_notify(targets, t);
+    }
+    keys_tested += count;
+
+    // Avisos de otros procesos y tiempo límite (cada DES_POLL_LATENCY segundos)
+    if(des_poll_due(&poll)){
+      if(des_poll_begin(&poll)){
+        timeout_reached = 1;
+        break;
+      }
+      des_targets_poll(targets);
+    }
+  }
+
+  double total_time = MPI_Wtime() - start_time;
+  des_targets_finish(targets);
+
+  unsigned long total_keys_tested;
+  MPI_Reduce(&keys_tested, &total_keys_tested, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+  int global_timeout;
+  MPI_Allreduce(&timeout_reached, &global_timeout, 1, MPI_INT, MPI_MAX, comm);
+
+  if(id == 0){
+    printf("\n RESULTADOS \n");
+    for(int t = 0; t < targets->n; t++){
+      if(targets->key[t] == -1){
+        printf("✗ [%d] %s: sin resolver\n", t, targets->name[t]);
+        continue;
+      }
+      char *temp = malloc(targets->len[t] + 1);
+      printf("✓ [%d] %s: clave %ld\n", t, targets->name[t], targets->key[t]);
+      if(temp){
+        memcpy(temp, targets->ciph[t], targets->len[t]);
+        temp[targets->len[t]] = 0;
+        decrypt(targets->key[t], temp, targets->len[t]);
+        printf("    \"%.60s%s\"\n", temp, strlen(temp) > 60 ? "..." : "");
+        free(temp);
+      }
+    }
+    if(targets->pending > 0){
+      printf("\n%d objetivos sin resolver (%s)\n", targets->pending,
+             global_timeout ? "tiempo agotado" : "rango agotado");
+    }
+
+    printf("\nEstadísticas:\n");
+    printf("  Total de claves probadas: %lu (cada una contra todos los objetivos pendientes)\n",
+           total_keys_tested);
+    printf("  Tiempo total: %.2f segundos\n", total_time);
+    printf("  Velocidad promedio: %.0f claves/segundo\n",
+           total_time > 0 ? total_keys_tested / total_time : 0.0);
+  }
+}
+
 void print_hex(unsigned char *data, int len){
   for(int i=0; i<len; i++){
     printf("%02x", data[i]);
@@ -130,11 +541,40 @@ void print_usage(const char *prog){
   printf("Uso:\n");
   printf("  Encriptar:    mpirun -np 1 %s -e \"mensaje\" -k KEY\n", prog);
   printf("  Desencriptar: mpirun -np 1 %s -d \"cipher_hex\" -k KEY\n", prog);
-  printf("  Bruteforce:   mpirun -np N %s -b -k KEY -s \"Key Frase to recognize\" -f file_name -m MAX_KEY\n", prog);
+  printf("  Bruteforce:   mpirun -np N %s -b -k KEY -s \"Key Frase to recognize\" -f file_name -m MAX_KEY [-c]\n", prog);
+  printf("                -c: modo complemento (texto conocido + bloque elegido, mitad de las claves)\n");
+  printf("                -p PREFIJO: inicio conocido del texto (texto o 0xHEX); -s pasa a ser opcional\n");
+  printf("                -t OBJETIVO: (repetible) archivo[:KEY] o texto cifrado en hex; un solo barrido\n");
+  printf("                   para todos los objetivos, cada uno se anuncia al resolverse (sin -c)\n");
+  printf("                --mode cbc --iv HEX: mensaje cifrado en CBC con IV de 16 dígitos hex\n");
+  printf("                   (el filtro sigue siendo el primer bloque: P0 = D(C0) ^ IV; sin -c, -x ni -t)\n");
+  printf("                --text-filter: descartar las claves cuyo primer bloque no es texto (sin bytes\n");
+  printf("                   de control) antes de descifrar el resto; mucho más rápido, pero no encuentra\n");
+  printf("                   mensajes binarios\n");
+  printf("                -x: buscar la frase (>= %d bytes) por bloques cifrados, sin filtro de texto\n", DES_CRIBSET_MIN);
+  printf("                --timeout SEG: tiempo límite de la búsqueda (por defecto %.0f, 0 = sin límite)\n", DEFAULT_TIMEOUT);
+  printf("                --checkpoint ARCHIVO: guardar los intervalos recorridos cada %.0f s (sin -t)\n", DES_CKPT_SECONDS);
+  printf("                --resume ARCHIVO: saltar lo recorrido según ARCHIVO y seguir guardando en él\n");
+  printf("                --shuffle [SEMILLA]: recorrer bloques de 2^%d claves en orden pseudoaleatorio (sin -t)\n",
+         DES_SHUFFLE_BLOCK_BITS);
+  printf("                --mask MASCARA: recorrer solo las claves de la máscara en vez de 0..MAX_KEY\n");
+  printf("                   (sin -c, -t ni --checkpoint): \"bits:N\" u 8 bytes, cada uno ? (libre),\n");
+  printf("                   ?l ?u ?d ?h ?a (clase), [bbbbbbb] (bits 7..1: 0, 1 o ?), \\xHH o un carácter fijo\n");
+  printf("                --wordlist ARCHIVO: claves derivadas de las palabras de ARCHIVO (una por línea)\n");
+  printf("                   en vez de un rango (sin -c, -t, --mask, --shuffle ni --checkpoint)\n");
+  printf("                --rules REGLAS: variantes de cada palabra (por defecto \":\"): : tal cual,\n");
+  printf("                   l minúsculas, u mayúsculas, c capitalizada, r al revés, y duplicada, d + dígito\n");
+  printf("                --derive str|pack|both: DES_string_to_key, 8 caracteres al bloque o las dos (both)\n");
+  printf("                --prepass [FAMILIAS]: antes del barrido, las claves que suele elegir una persona\n");
+  printf("                   (por defecto \"%s\"): p pocos bits en 1, s valores < 2^%d, r bytes repetidos,\n",
+         DES_PREPASS_ALL, DES_PREPASS_SMALL_BITS);
+  printf("                   a texto [0-9a-z], d fechas (sin -t, --mask ni --wordlist)\n");
   printf("\nEjemplos:\n");
   printf("  %s -e \"Hello the world\" -k 123456\n", prog);
   printf("  %s -d \"6cf5413f7dc89642\" -k 123456\n", prog);
   printf("  mpirun -np 4 %s -b \"6cf5413f7dc89642\"\n", prog);
+  printf("  mpirun -np 4 %s -b -k 123456 -s \"prueba\" --mask bits:40\n", prog);
+  printf("  mpirun -np 4 %s -b -k KEY -s \"prueba\" --mask \"clave?l?d\"\n", prog);
 }
 
 int main(int argc, char *argv[]){
@@ -145,6 +585,9 @@ int main(int argc, char *argv[]){
   MPI_Comm_size(comm, &N);
   MPI_Comm_rank(comm, &id);
 
+  des_bs_init();
+  des_bs_set_keymap(des_key_to_block);
+
   // argumentos faltantes
   if(argc < 2){ 
     if(id == 0) print_usage(argv[0]);
@@ -185,26 +628,36 @@ int main(int argc, char *argv[]){
     long known_key = 123456L;
     char input_file[256] = "input.txt";
 
-    MPI_Status st;
-    MPI_Request req;
-    long mylower, myupper;
     long found = -1;  // Inicializar en -1
-    int flag = 0;
-    double start_time, end_time, current_time;
+    double start_time, end_time;
     unsigned long keys_tested = 0;  // Cambiar a unsigned long
     int timeout_reached = 0;
+    int complement = 0;
+    int search_given = 0;
+    int crib_blocks = 0;
+    int crib_auto = 0;      // -x elegido por defecto (sin --text-filter)
+    int iv_given = 0;
+    int resume = 0;
+    int shuffle_given = 0;   // 1 = --shuffle, 2 = con semilla explícita
+    unsigned char known[3][8];   // P0, C0, ~C1 para el modo complemento
+    des_targets_t targets;       // objetivos de -t (targets.n == 0 si no se usa)
+    const char *target_args[DES_TARGETS_MAX];
+    int num_target_args = 0;
+
+    des_targets_init(&targets);
 
     if(id == 0){
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
                 known_key = atol(argv[++i]);
-                if (known_key <= 0) {
-                    fprintf(stderr, "Error: La clave debe ser un número positivo\n");
+                if (known_key <= 0 || !des_key_valid(known_key)) {
+                    fprintf(stderr, "Error: La clave debe estar entre 1 y %ld\n", DES_KEY_SPACE - 1);
                     MPI_Abort(comm, 1);
                 }
             } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
                 strncpy(search_str, argv[++i], sizeof(search_str) - 1);
                 search_str[sizeof(search_str) - 1] = '\0';
+                search_given = 1;
                 if (strlen(search_str) == 0) {
                     fprintf(stderr, "Error: La palabra de búsqueda no puede estar vacía\n");
                     MPI_Abort(comm, 1);
@@ -214,20 +667,233 @@ int main(int argc, char *argv[]){
                 input_file[sizeof(input_file) - 1] = '\0';
             } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
                 max_key = strtoul(argv[++i], NULL, 10);
+            } else if (strcmp(argv[i], "-c") == 0) {
+                complement = 1;
+            } else if (strcmp(argv[i], "-x") == 0) {
+                crib_blocks = 1;
+            } else if (strcmp(argv[i], "--text-filter") == 0) {
+                text_filter = 1;
+            } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+                if (num_target_args == DES_TARGETS_MAX) {
+                    fprintf(stderr, "Error: como máximo %d objetivos\n", DES_TARGETS_MAX);
+                    MPI_Abort(comm, 1);
+                }
+                target_args[num_target_args++] = argv[++i];
+            } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+                if (!des_mode_parse(&cipher_mode, argv[++i])) {
+                    fprintf(stderr, "Error: modo inválido (ecb o cbc)\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "--iv") == 0 && i + 1 < argc) {
+                if (!des_mode_parse_iv(&cipher_mode, argv[++i])) {
+                    fprintf(stderr, "Error: IV inválido (16 dígitos hexadecimales)\n");
+                    MPI_Abort(comm, 1);
+                }
+                iv_given = 1;
+            } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+                char *end;
+                timeout_seconds = strtod(argv[++i], &end);
+                if (*end != '\0' || timeout_seconds < 0) {
+                    fprintf(stderr, "Error: --timeout necesita segundos (0 = sin límite)\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if ((strcmp(argv[i], "--checkpoint") == 0 || strcmp(argv[i], "--resume") == 0)
+                       && i + 1 < argc) {
+                if (strcmp(argv[i], "--resume") == 0) resume = 1;
+                strncpy(checkpoint_path, argv[++i], sizeof(checkpoint_path) - 1);
+                checkpoint_path[sizeof(checkpoint_path) - 1] = '\0';
+            } else if (strcmp(argv[i], "--shuffle") == 0) {
+                shuffle_given = 1;
+                if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) {
+                    shuffle_seed = strtoul(argv[++i], NULL, 10);
+                    shuffle_given = 2;
+                }
+                if (shuffle_seed == 0) {
+                    shuffle_seed = des_shuffle_mix((uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32));
+                    if (shuffle_seed == 0) shuffle_seed = 1;
+                }
+            } else if (strcmp(argv[i], "--mask") == 0 && i + 1 < argc) {
+                if (!des_mask_parse(&key_mask, argv[++i])) {
+                    fprintf(stderr, "Error: máscara inválida (bits:N u 8 bytes: ?, ?l, ?u, ?d, ?h, ?a, [bbbbbbb], \\xHH o un carácter)\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "--wordlist") == 0 && i + 1 < argc) {
+                strncpy(wordlist_path, argv[++i], sizeof(wordlist_path) - 1);
+                wordlist_path[sizeof(wordlist_path) - 1] = '\0';
+                FILE *f = fopen(wordlist_path, "rb");
+                if (!f) {
+                    fprintf(stderr, "Error: no se pudo abrir la lista %s\n", wordlist_path);
+                    MPI_Abort(comm, 1);
+                }
+                fclose(f);
+            } else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+                strncpy(wordlist_rules, argv[++i], sizeof(wordlist_rules) - 1);
+                wordlist_rules[sizeof(wordlist_rules) - 1] = '\0';
+                if (!des_wordlist_rules_valid(wordlist_rules)) {
+                    fprintf(stderr, "Error: reglas inválidas (letras de \"%s\")\n", DES_WORDLIST_RULES);
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "--derive") == 0 && i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "str") == 0) wordlist_derive = DES_DERIVE_STRING;
+                else if (strcmp(argv[i], "pack") == 0) wordlist_derive = DES_DERIVE_PACK;
+                else if (strcmp(argv[i], "both") == 0) wordlist_derive = DES_DERIVE_STRING | DES_DERIVE_PACK;
+                else {
+                    fprintf(stderr, "Error: --derive debe ser str, pack o both\n");
+                    MPI_Abort(comm, 1);
+                }
+            } else if (strcmp(argv[i], "--prepass") == 0) {
+                // Familias opcionales: el siguiente argumento solo si son letras de familia
+                strcpy(prepass_families, DES_PREPASS_ALL);
+                if (i + 1 < argc && argv[i + 1][0] && strlen(argv[i + 1]) < sizeof(prepass_families) &&
+                    strspn(argv[i + 1], DES_PREPASS_ALL) == strlen(argv[i + 1])) {
+                    strcpy(prepass_families, argv[++i]);
+                }
+            } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+                if (!des_prefix_parse(&prefix, argv[++i])) {
+                    fprintf(stderr, "Error: prefijo inválido (texto o 0x seguido de hexadecimal)\n");
+                    MPI_Abort(comm, 1);
+                }
             }
         }
 
-        if (strlen(search_str) == 0) {
+        if (prefix.len > 0 && complement) {
+            fprintf(stderr, "Error: -p y -c no se pueden combinar\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (crib_blocks && (complement || prefix.len > 0)) {
+            fprintf(stderr, "Error: -x no se puede combinar con -c ni -p\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (num_target_args > 0 && complement) {
+            fprintf(stderr, "Error: -t no se puede combinar con -c\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (checkpoint_path[0] && num_target_args > 0) {
+            fprintf(stderr, "Error: --checkpoint y --resume no se pueden combinar con -t\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (shuffle_given && num_target_args > 0) {
+            fprintf(stderr, "Error: --shuffle no se puede combinar con -t\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (key_mask.active && (complement || num_target_args > 0 || checkpoint_path[0])) {
+            fprintf(stderr, "Error: --mask no se puede combinar con -c, -t ni --checkpoint\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (wordlist_path[0] && (complement || num_target_args > 0 || key_mask.active ||
+                                 shuffle_given || checkpoint_path[0])) {
+            fprintf(stderr, "Error: --wordlist no se puede combinar con -c, -t, --mask, --shuffle ni --checkpoint\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (prepass_families[0] && (num_target_args > 0 || key_mask.active || wordlist_path[0])) {
+            fprintf(stderr, "Error: --prepass no se puede combinar con -t, --mask ni --wordlist\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (cipher_mode.cbc && !iv_given) {
+            fprintf(stderr, "Error: --mode cbc necesita --iv\n");
+            MPI_Abort(comm, 1);
+        }
+
+        if (cipher_mode.cbc && (complement || crib_blocks || num_target_args > 0)) {
+            fprintf(stderr, "Error: --mode cbc no se puede combinar con -c, -x ni -t\n");
+            MPI_Abort(comm, 1);
+        }
+
+        // -p compara D(C0) con el primer bloque esperado, que en CBC es P0 ^ IV
+        des_mode_adjust_prefix(&cipher_mode, &prefix);
+
+        // Los archivos sin :KEY se cifran con -k, que puede ir después de -t
+        for (int i = 0; i < num_target_args; i++) {
+            if (!des_targets_add(&targets, target_args[i], known_key, MAX_TEXT)) {
+                MPI_Abort(comm, 1);
+            }
+        }
+
+        if (crib_blocks && strlen(search_str) < DES_CRIBSET_MIN) {
+            fprintf(stderr, "Error: -x necesita una frase de al menos %d bytes\n", DES_CRIBSET_MIN);
+            MPI_Abort(comm, 1);
+        }
+
+        // Sin --text-filter no se puede descartar por el primer bloque. En ECB, con una frase
+        // que cubre las 8 alineaciones, la búsqueda por bloques (-x) tampoco pierde claves y
+        // cuesta unos pocos cifrados bitsliced por clave en lugar de descifrar el mensaje
+        if (!text_filter && !crib_blocks && !complement && prefix.len == 0 && !cipher_mode.cbc &&
+            strlen(search_str) >= DES_CRIBSET_MIN) {
+            crib_blocks = crib_auto = 1;
+        }
+
+        // Con texto conocido la frase solo se comprueba si se pidió explícitamente
+        if (prefix.len > 0 && !search_given) {
+            search_str[0] = '\0';
+        }
+
+        if (strlen(search_str) == 0 && prefix.len == 0) {
             fprintf(stderr, "Error: Debe proporcionar palabra de búsqueda con -s\n\n");
             MPI_Abort(comm, 1);
         }
+
+        if (!des_bs_selftest()) {
+            fprintf(stderr, "Error: el kernel DES bitsliced no coincide con OpenSSL\n");
+            MPI_Abort(comm, 1);
+        }
     }
 
     // Broadcast de todos los parámetros
     MPI_Bcast(&known_key, 1, MPI_LONG, 0, comm);
     MPI_Bcast(search_str, 256, MPI_CHAR, 0, comm);
+    des_crib_init(&crib, search_str);
     MPI_Bcast(input_file, 256, MPI_CHAR, 0, comm);
     MPI_Bcast(&max_key, 1, MPI_UNSIGNED_LONG, 0, comm);
+    MPI_Bcast(&complement, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&prefix, sizeof(prefix), MPI_BYTE, 0, comm);
+    MPI_Bcast(&crib_blocks, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&cipher_mode, sizeof(cipher_mode), MPI_BYTE, 0, comm);
+    MPI_Bcast(&text_filter, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&timeout_seconds, 1, MPI_DOUBLE, 0, comm);
+    MPI_Bcast(&key_mask, sizeof(key_mask), MPI_BYTE, 0, comm);
+    MPI_Bcast(wordlist_path, sizeof(wordlist_path), MPI_CHAR, 0, comm);
+    MPI_Bcast(wordlist_rules, sizeof(wordlist_rules), MPI_CHAR, 0, comm);
+    MPI_Bcast(&wordlist_derive, 1, MPI_INT, 0, comm);
+    MPI_Bcast(prepass_families, sizeof(prepass_families), MPI_CHAR, 0, comm);
+    des_targets_bcast(&targets, 0, comm);
+    targets.text = text_filter;
+
+    // Con --mask se barre el contador de la máscara: el kernel recibe valores del contador
+    if(key_mask.active){
+        max_key = key_mask.count;
+        des_mask_bs_setup(&key_mask);
+    }
+
+    if (targets.n > 0) {
+        if (id == 0) {
+            printf("DES BRUTE FORCE MPI - MULTIOBJETIVO\n");
+            printf("Frase clave a buscar: \"%s\"\n", search_str);
+        }
+        if (crib_blocks && !des_cribset_init(&cribset, (unsigned char *)search_str,
+                                             strlen(search_str), des_targets_blocks(&targets))) {
+            fprintf(stderr, "Error: no se pudo preparar la búsqueda por bloques\n");
+            MPI_Abort(comm, 1);
+        }
+        if (!des_targets_index(&targets, &prefix, crib_blocks ? &cribset : NULL)) {
+            fprintf(stderr, "Error: no se pudo preparar la tabla de objetivos\n");
+            MPI_Abort(comm, 1);
+        }
+        search_targets(&targets, max_key, crib_blocks ? &cribset : NULL, comm);
+        des_targets_free(&targets);
+        des_cribset_free(&cribset);
+        free(cipher);
+        MPI_Finalize();
+        return 0;
+    }
 
     if (id == 0) {
         FILE *f = fopen(input_file, "rb");
@@ -249,7 +915,16 @@ int main(int argc, char *argv[]){
         printf("Archivo de entrada: %-35s\n", input_file);
         printf("Texto original: %s\n", cipher);
         
-        encrypt(known_key, (char*)cipher, len);
+        // Bloque conocido P0 y bloque elegido ~P0, cifrados con la misma clave
+        for(int i = 0; i < 8; i++){
+            known[0][i] = cipher[i];
+            known[2][i] = ~cipher[i];
+        }
+        encrypt(known_key, (char*)known[2], 8);
+        for(int i = 0; i < 8; i++) known[2][i] = ~known[2][i];
+
+        des_mode_crypt(&cipher_mode, known_key, cipher, len, 1);
+        memcpy(known[1], cipher, 8);
         printf("Texto encriptado (primeros 32 bytes): ");
         for(int i = 0; i < (len < 32 ? len : 32); i++){
             printf("%02x", cipher[i]);
@@ -260,103 +935,247 @@ int main(int argc, char *argv[]){
     // Difundir ciphertext
     MPI_Bcast(&len, 1, MPI_INT, 0, comm);
     MPI_Bcast(cipher, len, MPI_UNSIGNED_CHAR, 0, comm);
+    verify_kernel = des_verify_select(len, &crib);
+    MPI_Bcast(known, sizeof(known), MPI_UNSIGNED_CHAR, 0, comm);
+
+    if(crib_blocks){
+        if(!des_cribset_init(&cribset, (unsigned char *)search_str, strlen(search_str), len / 8)){
+            fprintf(stderr, "Error: no se pudo preparar la búsqueda por bloques\n");
+            MPI_Abort(comm, 1);
+        }
+        des_cribset_add(&cribset, cipher, len, 0);
+    }
+
+    // En modo complemento solo se recorren los representantes [0, 2^55): cada uno cubre
+    // también su complemento
+    unsigned long sweep_key = max_key;
+    if(complement && sweep_key > (unsigned long)DES_KEY_SPACE / 2){
+        sweep_key = DES_KEY_SPACE / 2;
+    }
+
+    // Intervalos ya recorridos (solo el proceso 0 los conoce y los guarda). Los de
+    // complemento son de representantes, por eso el modo va en el archivo.
+    des_ckpt_t ckpt;
+    des_ckpt_init(&ckpt, complement);
+    ckpt.seed = shuffle_seed;
+    if(id == 0 && resume){
+        if(!des_ckpt_load(&ckpt, checkpoint_path)){
+            fprintf(stderr, "Error: no se pudo leer el checkpoint %s (o es de otro modo)\n", checkpoint_path);
+            MPI_Abort(comm, 1);
+        }
+        // Se reanuda con la permutación del archivo
+        if((shuffle_given && ckpt.seed == 0) || (shuffle_given == 2 && ckpt.seed != shuffle_seed)){
+            fprintf(stderr, "Error: --shuffle no coincide con el del checkpoint %s\n", checkpoint_path);
+            MPI_Abort(comm, 1);
+        }
+        shuffle_seed = ckpt.seed;
+    }
+    MPI_Bcast(&shuffle_seed, 1, MPI_UNSIGNED_LONG, 0, comm);
+
+    // Con --shuffle el reparto es de bloques virtuales (des_shuffle.h)
+    des_shuffle_t shuffle;
+    des_shuffle_init(&shuffle, sweep_key, shuffle_seed);
+
+    des_prepass_t prepass;
+    if(prepass_families[0] && !des_prepass_init(&prepass, prepass_families)){
+        if(id == 0) fprintf(stderr, "Error: familias de --prepass inválidas (letras de \"%s\")\n", DES_PREPASS_ALL);
+        MPI_Abort(comm, 1);
+    }
     
     if (id == 0) {
-        printf("\nRango de búsqueda: 0 a %lu\n", max_key);
+        if(wordlist_path[0]){
+            printf("\nLista de palabras: %s (reglas \"%s\", derivación %s)\n", wordlist_path,
+                   wordlist_rules, wordlist_derive == DES_DERIVE_STRING ? "DES_string_to_key" :
+                   wordlist_derive == DES_DERIVE_PACK ? "8 caracteres al bloque" : "DES_string_to_key y 8 caracteres");
+            printf("Lectura: MPI-IO, bloques de %ld MB por proceso con lectura anticipada\n",
+                   DES_WORDLIST_BLOCK >> 20);
+        } else if(key_mask.active){
+            char mask_info[160];
+            des_mask_describe(&key_mask, mask_info, sizeof(mask_info));
+            printf("\nMáscara: \"%s\" (%s): %lu claves\n", key_mask.spec, mask_info, max_key);
+        } else {
+            printf("\nRango de búsqueda: 0 a %lu\n", max_key);
+        }
+        if(complement){
+            printf("Modo complemento: %lu representantes (k y ~k por cifrado)\n", sweep_key);
+        }
         printf("Número de procesos: %d\n", N);
-        printf("Timeout: %.0f segundos\n", TIMEOUT_SECONDS);
+        if(timeout_seconds > 0){
+            printf("Timeout: %.0f segundos\n", timeout_seconds);
+        } else {
+            printf("Timeout: sin límite\n");
+        }
+        if(!wordlist_path[0]){
+            printf("Reparto: dinámico desde el proceso 0 (trozos de ~%.2fs, el primero de %ld claves)\n",
+                   DES_SCHED_SECONDS, DES_SCHED_MIN);
+        }
+        if(checkpoint_path[0]){
+            printf("Checkpoint: %s (cada %.0f s)\n", checkpoint_path, DES_CKPT_SECONDS);
+        }
+        if(shuffle_seed){
+            printf("Orden: pseudoaleatorio por bloques de 2^%d claves (semilla %lu)\n",
+                   DES_SHUFFLE_BLOCK_BITS, shuffle_seed);
+        }
+        if(prepass_families[0]){
+            char prepass_info[256];
+            des_prepass_describe(&prepass, prepass_info, sizeof(prepass_info));
+            printf("Pasada previa: %lu claves (%s)\n", prepass.total, prepass_info);
+        }
+        if(resume){
+            printf("Reanudando: %ld claves ya recorridas en %d intervalos\n",
+                   des_ckpt_covered(&ckpt, des_shuffle_end(&shuffle)), ckpt.n);
+        }
+        printf("Kernel DES: %s (%d claves por lote)\n", des_bs_kernel_name, des_bs_lanes());
+        char kernel[96];
+        des_verify_describe(kernel, sizeof(kernel), len, &crib);
+        printf("Modo: %s\n", des_mode_name(&cipher_mode));
+        if(crib_blocks || prefix.len > 0){
+            printf("Verificación: descifrado completo de los aciertos del filtro del modo\n");
+        } else if(!text_filter){
+            printf("Verificación: descifrado completo y búsqueda de la frase (sin --text-filter)\n");
+        } else {
+            printf("Verificación: %s\n", cipher_mode.cbc ? "general CBC (encadenada)" : kernel);
+        }
         printf("Frase clave a buscar: \"%s\"\n", search_str);
+        if(prefix.len > 0){
+            printf("Texto conocido: %d bytes (%d en el primer bloque)\n",
+                   prefix.len, prefix.len < 8 ? prefix.len : 8);
+        }
+        if(crib_blocks){
+            printf("Frase por bloques: %d fragmentos cifrados por clave%s\n", cribset.nchunks,
+                   crib_auto ? " (por defecto sin --text-filter)" : "");
+        }
         printf("\nIniciando búsqueda...\n\n");
     }
 
-    // Calcular rango de cada proceso
-    unsigned long range_per_node = max_key / N;
-    mylower = range_per_node * id;
-    myupper = range_per_node * (id + 1);
-    if(id == N - 1){
-        myupper = max_key;  // Último proceso toma el residuo
-    }
-
-    printf("Proceso %d: rango [%ld, %ld] - %ld claves\n", 
-           id, mylower, myupper, myupper - mylower);
-
     // Sincronizar antes de empezar
     MPI_Barrier(comm);
     start_time = MPI_Wtime();
 
-    // CRÍTICO: Iniciar recepción no bloqueante
-    MPI_Irecv(&found, 1, MPI_LONG, MPI_ANY_SOURCE, 0, comm, &req);
+    // Señal de parada: bandera en una ventana RMA del proceso 0
+    des_stop_t stop;
+    des_stop_init(&stop, comm);
 
-    unsigned long last_report = mylower;
+    unsigned long next_progress = PROGRESS_INTERVAL;
+    des_poll_t poll;
+    long hits[DES_BS_LANES];
+    static des_bs_keys batch_keys;
+    des_shuffle_walk_t walk;
+    long key;
+    int count;
 
-    // Búsqueda con condición correcta
-    for(unsigned long key = mylower; key < myupper && found == -1; key++){
-        
-        // Verificar timeout
-        current_time = MPI_Wtime();
-        if((current_time - start_time) > TIMEOUT_SECONDS){
-            timeout_reached = 1;
-            if(id == 0){
-                printf("\n⏰ TIMEOUT alcanzado (%.0f segundos)\n", TIMEOUT_SECONDS);
-            }
-            break;
-        }
+    // Reparto dinámico: cada trozo de [0, sweep_key) se recorre por lotes de des_bs_lanes()
+    // claves en orden Gray (con --shuffle, por tramos de los bloques reales que le
+    // corresponden). El proceso 0 atiende las peticiones de trozos entre lote y lote.
+    des_sched_t sched;
+    long chunk_base, chunk_count;
 
-        // Probar la clave
-        if(tryKey((long)key, cipher, len)){
-            found = key;
-            printf("\n✓ Proceso %d ENCONTRÓ LA CLAVE: %ld\n", id, key);
+    des_bs_keys_init(&batch_keys);
+    des_poll_init(&poll, DES_POLL_LATENCY, timeout_seconds, start_time);
+
+    // Con --wordlist las claves salen de la lista y el reparto no tiene rango que repartir
+    unsigned long words = 0;
+    if(wordlist_path[0]){
+        found = search_wordlist(&stop, &poll, cipher, len, crib_blocks, &keys_tested, &words,
+                                &timeout_reached, start_time, comm);
+    }
+    // Con --prepass primero las familias de claves elegidas por personas; si no aparece la
+    // clave, el barrido completo. Todos terminan la pasada antes de seguir.
+    if(prepass_families[0]){
+        found = search_prepass(&prepass, &stop, &poll, cipher, len, crib_blocks, &keys_tested,
+                               &timeout_reached, comm);
+        MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_LONG, MPI_MAX, comm);
+        MPI_Allreduce(MPI_IN_PLACE, &timeout_reached, 1, MPI_INT, MPI_MAX, comm);
+        if(id == 0 && found == -1 && !timeout_reached){
+            printf("Pasada previa terminada sin encontrar la clave: barrido completo\n");
+        }
+    }
+    des_sched_init(&sched, 0, wordlist_path[0] ? 0 : des_shuffle_end(&shuffle), des_bs_lanes(), comm);
+    if(id == 0 && checkpoint_path[0]) sched.ckpt = &ckpt;
+    // El tramo contiguo de la pasada (valores pequeños) no se repite: el proceso 0 lo marca
+    // como recorrido. En modo complemento o con --shuffle el barrido no es de claves en orden.
+    long covered_lo, covered_hi;
+    if(id == 0 && prepass_families[0] && !complement && !shuffle_seed &&
+       des_prepass_range(&prepass, &covered_lo, &covered_hi)){
+        des_ckpt_add(&ckpt, covered_lo, covered_hi < (long)sweep_key ? covered_hi : (long)sweep_key);
+        sched.ckpt = &ckpt;
+    }
+    while(found == -1 && !timeout_reached && des_sched_next(&sched, &chunk_base, &chunk_count)){
+        des_shuffle_walk_init(&walk, &shuffle, chunk_base, chunk_base + chunk_count, des_bs_lanes());
+        while(found == -1 && des_shuffle_walk_next(&walk, &key, &count)){
+            // Probar el lote
+            int num_hits;
+            if(complement){
+                num_hits = tryKeysComplement(&batch_keys, key, count, known, cipher, len, hits);
+            } else if(prefix.len > 0){
+                num_hits = tryKeysPrefix(&batch_keys, key, count, cipher, len, hits);
+            } else if(crib_blocks){
+                num_hits = tryKeysCrib(&batch_keys, key, count, cipher, len, hits);
+            } else {
+                num_hits = tryKeys(&batch_keys, key, count, cipher, len, hits);
+            }
+            if(num_hits > 0){
+                found = hits[0];
+                printf("\n✓ Proceso %d ENCONTRÓ LA CLAVE: %ld\n", id, found);
             
-            // Notificar a todos los demás procesos
-            for(int node = 0; node < N; node++){
-                if(node != id){
-                    MPI_Send(&found, 1, MPI_LONG, node, 0, comm);
-                }
+                // Avisar a los demás: una sola operación atómica sobre la bandera
+                des_stop_post(&stop, found);
+                break;
             }
-            break;
-        }
         
-        keys_tested++;
-
-        // Verificar si otro proceso encontró la clave (cada 10k iteraciones)
-        if(keys_tested % 10000 == 0){
-            MPI_Test(&req, &flag, &st);
-            if(flag && found != -1){
-                printf("Proceso %d: deteniendo búsqueda (clave encontrada por proceso %d)\n", 
-                       id, st.MPI_SOURCE);
-                break;
+            keys_tested += complement ? 2 * count : count;
+
+            // Cada DES_POLL_LATENCY segundos: tiempo límite, aviso de parada y progreso
+            if(des_poll_due(&poll)){
+                if(des_poll_begin(&poll)){
+                    timeout_reached = 1;
+                    if(id == 0){
+                        printf("\n⏰ TIMEOUT alcanzado (%.0f segundos)\n", timeout_seconds);
+                    }
+                    break;
+                }
+                if(des_stop_check(&stop, &found)){
+                    printf("Proceso %d: deteniendo búsqueda (clave encontrada por otro proceso)\n", 
+                           id);
+                    break;
+                }
+
+                if(checkpoint_path[0] && sched.ckpt && !des_ckpt_tick(&ckpt, checkpoint_path, poll.now)){
+                    fprintf(stderr, "Aviso: no se pudo escribir el checkpoint %s\n", checkpoint_path);
+                }
+
+                // Reportar progreso cada PROGRESS_INTERVAL claves (solo proceso 0)
+                if(id == 0 && keys_tested >= next_progress){
+                    while(next_progress <= keys_tested) next_progress += PROGRESS_INTERVAL;
+                    double elapsed = poll.now - start_time;
+                    unsigned long total_estimate = keys_tested * N;
+                    double rate = total_estimate / elapsed;
+                    double progress = ((double)total_estimate / max_key) * 100.0;
+                
+                    printf("[Progreso] %.4f%% | %lu claves | %.0f k/s | %.2fs\n", 
+                           progress, total_estimate, rate/1000.0, elapsed);
+                }
             }
-        }
 
-        // Reportar progreso cada PROGRESS_INTERVAL claves (solo proceso 0)
-        if(id == 0 && keys_tested % PROGRESS_INTERVAL == 0){
-            double elapsed = current_time - start_time;
-            unsigned long total_estimate = keys_tested * N;
-            double rate = total_estimate / elapsed;
-            double progress = ((double)key / max_key) * 100.0;
-            
-            printf("[Progreso] %.4f%% | %lu claves | %.0f k/s | %.2fs\n", 
-                   progress, total_estimate, rate/1000.0, elapsed);
+            des_sched_serve(&sched);
         }
     }
-
-    // Cancelar recepción pendiente
-    int test_flag;
-    MPI_Test(&req, &test_flag, &st);
-    if (!test_flag) {
-        MPI_Cancel(&req);
+    des_sched_finish(&sched);
+    if(checkpoint_path[0] && sched.ckpt && !des_ckpt_save(&ckpt, checkpoint_path)){
+        fprintf(stderr, "Aviso: no se pudo escribir el checkpoint %s\n", checkpoint_path);
     }
-    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    des_ckpt_free(&ckpt);
+
+    // Todos leen el valor final de la bandera (si dos procesos encontraron, gana la menor)
+    found = des_stop_finish(&stop);
 
     end_time = MPI_Wtime();
     double total_time = end_time - start_time;
 
-    // Asegurar que todos tengan la clave encontrada
-    MPI_Bcast(&found, 1, MPI_LONG, 0, comm);
-
     // Recolectar estadísticas
-    unsigned long total_keys_tested;
+    unsigned long total_keys_tested, total_words;
     MPI_Reduce(&keys_tested, &total_keys_tested, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(&words, &total_words, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
     
     int global_timeout;
     MPI_Allreduce(&timeout_reached, &global_timeout, 1, MPI_INT, MPI_MAX, comm);
@@ -365,23 +1184,31 @@ int main(int argc, char *argv[]){
         printf("\n RESULTADOS \n");
         
         if(found != -1){
-            printf("✓ ¡CLAVE ENCONTRADA: %ld!\n\n", found);
+            printf("✓ ¡CLAVE ENCONTRADA: %ld!\n", found);
+            des_key_print_class(stdout, found);
+            printf("\n");
             
             // Descifrar y mostrar mensaje
             char *temp = malloc(len + 1);
             if(temp){
                 memcpy(temp, cipher, len);
                 temp[len] = 0;
-                decrypt(found, temp, len);
+                des_mode_crypt(&cipher_mode, found, (unsigned char *)temp, len, 0);
                 printf("Mensaje desencriptado:\n\"%s\"\n\n", temp);
                 free(temp);
             }
         } else {
             if(global_timeout){
                 printf("✗ Tiempo agotado - No se encontró la clave en %.0f segundos\n\n", 
-                       TIMEOUT_SECONDS);
+                       timeout_seconds);
             } else {
-                printf("✗ No se encontró la clave en el rango 0..%lu\n\n", max_key);
+                if(wordlist_path[0]){
+                    printf("✗ No se encontró la clave en la lista %s\n\n", wordlist_path);
+                } else if(key_mask.active){
+                    printf("✗ No se encontró la clave en las %lu claves de la máscara\n\n", max_key);
+                } else {
+                    printf("✗ No se encontró la clave en el rango 0..%lu\n\n", max_key);
+                }
             }
         }
 
@@ -390,10 +1217,15 @@ int main(int argc, char *argv[]){
         printf("  Tiempo total: %.2f segundos\n", total_time);
         printf("  Velocidad promedio: %.0f claves/segundo\n", 
                total_time > 0 ? total_keys_tested / total_time : 0.0);
-        printf("  Porcentaje explorado: %.6f%%\n", 
-               ((double)total_keys_tested / max_key) * 100.0);
+        if(wordlist_path[0]){
+            printf("  Palabras leídas: %lu\n", total_words);
+        } else {
+            printf("  Porcentaje explorado: %.6f%%\n", 
+                   ((double)total_keys_tested / max_key) * 100.0);
+        }
     }
     
+    des_cribset_free(&cribset);
     free(cipher);
 }
   else {
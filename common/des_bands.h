@@ -0,0 +1,198 @@
+#ifndef DES_BANDS_H
+#define DES_BANDS_H
+
+// Búsqueda radial con varias pistas de distinta confianza. Cada pista (clave, peso, radio)
+// reparte su peso sobre [clave - radio, clave + radio] con densidad que baja linealmente con
+// la distancia: una clave a distancia d vale peso * (radio + 1 - d) / (radio + 1)^2. El
+// espacio de cada pista se corta en bandas de DES_BAND_WIDTH distancias (las dos mitades,
+// hasta 2^16 claves) y las bandas de todas las pistas se ordenan de mayor a menor
+// probabilidad por clave. Como la densidad de cada pista baja con la distancia, basta
+// comparar la próxima banda de cada una (des_bands_next).
+//
+// El orden es determinista y cada proceso lo genera por su cuenta; la banda que toca se
+// pide a un contador compartido (des_counter_t, un MPI_Fetch_and_op sobre una ventana del
+// proceso 0). Así todos avanzan juntos por el mismo orden de prioridad y el tiempo esperado
+// hasta la clave es el mínimo, en vez de agotar una pista antes de empezar la siguiente.
+// Las claves en el solape de dos pistas se prueban una vez por pista.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#define DES_HINTS_MAX 64
+#define DES_BAND_WIDTH (1L << 15)   // distancias por banda
+
+typedef struct {
+    long key;
+    double weight;
+    long radius;   // 0 = el radio por defecto (-r)
+} des_hint_t;
+
+typedef struct {
+    des_hint_t hint[DES_HINTS_MAX];
+    int n;
+    long next[DES_HINTS_MAX];   // próxima banda de cada pista
+    long index;                 // posición de la próxima banda en el orden global
+} des_bands_t;
+
+// "clave[:peso[:radio]]". Devuelve 0 si no tiene ese formato.
+static inline int des_hint_parse(des_hint_t *h, const char *arg) {
+    char *end;
+
+    h->key = strtol(arg, &end, 10);
+    h->weight = 1.0;
+    h->radius = 0;
+    if (end == arg) return 0;
+    if (*end == ':') {
+        arg = end + 1;
+        h->weight = strtod(arg, &end);
+        if (end == arg) return 0;
+        if (*end == ':') {
+            arg = end + 1;
+            h->radius = strtol(arg, &end, 10);
+            if (end == arg) return 0;
+        }
+    }
+    return *end == '\0' && h->weight > 0 && h->radius >= 0;
+}
+
+// Una pista por línea: "clave [peso [radio]]"; '#' empieza un comentario. Devuelve 0 si el
+// archivo no existe, tiene una línea mal formada o demasiadas pistas.
+static inline int des_bands_load(des_bands_t *b, const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[256];
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f)) {
+        char *p = strchr(line, '#');
+        if (p) *p = '\0';
+        for (p = line; *p; p++) {
+            if (*p == ' ' || *p == '\t') *p = ':';
+            if (*p == '\n' || *p == '\r') *p = '\0';
+        }
+        p = line;
+        while (*p == ':') p++;
+        if (*p == '\0') continue;
+        for (char *q = p + strlen(p); q > p && q[-1] == ':'; q--) q[-1] = '\0';
+        if (b->n == DES_HINTS_MAX || !des_hint_parse(&b->hint[b->n], p)) {
+            fclose(f);
+            return 0;
+        }
+        b->n++;
+    }
+    fclose(f);
+    return 1;
+}
+
+// Vuelve al principio del orden
+static inline void des_bands_reset(des_bands_t *b) {
+    memset(b->next, 0, sizeof(b->next));
+    b->index = 0;
+}
+
+// Probabilidad (sin normalizar) de una clave a distancia d de la pista
+static inline double des_bands_density(const des_hint_t *h, long d) {
+    double r1 = (double)h->radius + 1;
+    return h->weight * (r1 - d) / (r1 * r1);
+}
+
+// Número total de bandas
+static inline long des_bands_count(const des_bands_t *b) {
+    long total = 0;
+    for (int i = 0; i < b->n; i++) total += b->hint[i].radius / DES_BAND_WIDTH + 1;
+    return total;
+}
+
+// Siguiente banda del orden: pista y distancias [*d0, *d1). Devuelve 0 si no quedan.
+static inline int des_bands_next(des_bands_t *b, int *hint, long *d0, long *d1) {
+    int best = -1;
+    double best_density = 0;
+
+    for (int i = 0; i < b->n; i++) {
+        long d = b->next[i] * DES_BAND_WIDTH;
+        if (d > b->hint[i].radius) continue;
+        double density = des_bands_density(&b->hint[i], d);
+        if (best < 0 || density > best_density) {
+            best = i;
+            best_density = density;
+        }
+    }
+    if (best < 0) return 0;
+
+    *hint = best;
+    *d0 = b->next[best] * DES_BAND_WIDTH;
+    *d1 = *d0 + DES_BAND_WIDTH;
+    if (*d1 > b->hint[best].radius + 1) *d1 = b->hint[best].radius + 1;
+    b->next[best]++;
+    b->index++;
+    return 1;
+}
+
+// Banda número k del orden (k no puede ser menor que en la llamada anterior)
+static inline int des_bands_get(des_bands_t *b, long k, int *hint, long *d0, long *d1) {
+    while (b->index < k) {
+        if (!des_bands_next(b, hint, d0, d1)) return 0;
+    }
+    return des_bands_next(b, hint, d0, d1);
+}
+
+// Posición de una clave dentro del orden: banda, luego distancia a la pista y luego lado
+// (primero pista - d). Entre dos aciertos, el de menor posición es el más probable; dentro
+// de una banda, el más cercano a su pista. center y d0 son los de la banda.
+static inline long des_bands_position(long band, long d0, long center, long key) {
+    long d = labs(key - center);
+    return band * 2 * DES_BAND_WIDTH + 2 * (d - d0) + (key > center);
+}
+
+// Banda de una posición
+static inline long des_bands_band(long position) {
+    return position / (2 * DES_BAND_WIDTH);
+}
+
+// Clave en una posición (inversa de des_bands_position). Devuelve -1 si no existe.
+static inline long des_bands_key(const des_bands_t *b, long position) {
+    des_bands_t order = *b;
+    int hint;
+    long d0, d1, rest = position % (2 * DES_BAND_WIDTH);
+
+    des_bands_reset(&order);
+    if (!des_bands_get(&order, des_bands_band(position), &hint, &d0, &d1)) return -1;
+    long d = d0 + rest / 2;
+    return (rest & 1) ? b->hint[hint].key + d : b->hint[hint].key - d;
+}
+
+// Contador compartido: un long en una ventana del proceso 0, incrementado de forma atómica
+typedef struct {
+    MPI_Win win;
+    long *value;
+} des_counter_t;
+
+// Colectiva
+static inline void des_counter_init(des_counter_t *c, MPI_Comm comm) {
+    int id;
+
+    MPI_Comm_rank(comm, &id);
+    MPI_Win_allocate(id == 0 ? sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, comm,
+                     &c->value, &c->win);
+    if (id == 0) *c->value = 0;
+    MPI_Barrier(comm);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, c->win);
+}
+
+// Devuelve el valor actual y lo incrementa
+static inline long des_counter_next(des_counter_t *c) {
+    long one = 1, previous;
+
+    MPI_Fetch_and_op(&one, &previous, MPI_LONG, 0, 0, MPI_SUM, c->win);
+    MPI_Win_flush(0, c->win);
+    return previous;
+}
+
+// Colectiva
+static inline void des_counter_free(des_counter_t *c) {
+    MPI_Win_unlock_all(c->win);
+    MPI_Win_free(&c->win);
+}
+
+#endif
@@ -0,0 +1,351 @@
+#ifndef DES_BS_H
+#define DES_BS_H
+
+// DES "bitsliced": evalúa muchas claves a la vez. Cada variable guarda el mismo bit del
+// estado DES para 64, 256 o 512 claves distintas (un "carril" por clave), así que las
+// S-boxes se calculan con AND/OR/XOR y las permutaciones son solo índices.
+// El key schedule no cuesta nada: cada bit de subclave es directamente un bit de la clave.
+//
+// El kernel (des_bs_kernel.h) se instancia para uint64_t y, en x86, para vectores AVX2 y
+// AVX-512; des_bs_init() elige el más ancho que soporte la CPU (variable de entorno
+// DES_BS_WIDTH=64|256|512 para limitarlo). El mismo binario sirve en todos los nodos.
+
+#include <stdint.h>
+#include <string.h>
+#include <openssl/des.h>
+
+#include <stdlib.h>
+#include "des_tables.h"
+#include "des_sp.h"
+
+#define DES_BS_LANES 512   // Máximo de carriles de cualquier kernel (tamaño de los lotes)
+
+// des_bs_ks[ronda][j] = bit de la clave (0..63, numeración DES) que alimenta el bit j
+// de la subclave de esa ronda. Se llena en des_bs_init().
+static unsigned char des_bs_ks[16][48];
+
+// S-box como función booleana: los 16 mintérminos de la columna (bits 2..5) se combinan
+// con OR según la tabla y se seleccionan con la fila (bits 1 y 6). Las condiciones sobre
+// des_sbox son constantes, el compilador las resuelve (requiere -O1 o superior).
+#define DES_BS_SEL(s, r, c, o) (((des_sbox[s][r][c] >> (3 - (o))) & 1) ? m[c] : zero)
+#define DES_BS_ROW(s, r, o) \
+    (DES_BS_SEL(s, r,  0, o) | DES_BS_SEL(s, r,  1, o) | DES_BS_SEL(s, r,  2, o) | \
+     DES_BS_SEL(s, r,  3, o) | DES_BS_SEL(s, r,  4, o) | DES_BS_SEL(s, r,  5, o) | \
+     DES_BS_SEL(s, r,  6, o) | DES_BS_SEL(s, r,  7, o) | DES_BS_SEL(s, r,  8, o) | \
+     DES_BS_SEL(s, r,  9, o) | DES_BS_SEL(s, r, 10, o) | DES_BS_SEL(s, r, 11, o) | \
+     DES_BS_SEL(s, r, 12, o) | DES_BS_SEL(s, r, 13, o) | DES_BS_SEL(s, r, 14, o) | \
+     DES_BS_SEL(s, r, 15, o))
+#define DES_BS_OUT(s, o) \
+    ((DES_BS_ROW(s, 0, o) & rs[0]) | (DES_BS_ROW(s, 1, o) & rs[1]) | \
+     (DES_BS_ROW(s, 2, o) & rs[2]) | (DES_BS_ROW(s, 3, o) & rs[3]))
+
+#define DES_BS_SBOX(s)                                                        \
+DES_BS_ATTR static inline void DES_BS_FN(des_bs_sbox##s)(const DES_BS_T *x,   \
+                                                          DES_BS_T *out) {    \
+    DES_BS_T h[4], l[4], m[16], rs[4], zero = {0};                            \
+    h[0] = ~x[1] & ~x[2]; h[1] = ~x[1] & x[2];                                \
+    h[2] = x[1] & ~x[2];  h[3] = x[1] & x[2];                                 \
+    l[0] = ~x[3] & ~x[4]; l[1] = ~x[3] & x[4];                                \
+    l[2] = x[3] & ~x[4];  l[3] = x[3] & x[4];                                 \
+    for (int c = 0; c < 16; c++) m[c] = h[c >> 2] & l[c & 3];                 \
+    rs[0] = ~x[0] & ~x[5]; rs[1] = ~x[0] & x[5];                              \
+    rs[2] = x[0] & ~x[5];  rs[3] = x[0] & x[5];                               \
+    out[0] = DES_BS_OUT(s, 0);                                                \
+    out[1] = DES_BS_OUT(s, 1);                                                \
+    out[2] = DES_BS_OUT(s, 2);                                                \
+    out[3] = DES_BS_OUT(s, 3);                                                \
+}
+
+#define DES_BS_CAT_(a, b) a##_##b
+#define DES_BS_CAT(a, b) DES_BS_CAT_(a, b)
+#define DES_BS_FN(name) DES_BS_CAT(name, DES_BS_SUFFIX)
+
+// Transposición 64x64 de bits (Hacker's Delight, 7-3): a[i] bit 63-j <-> a[j] bit 63-i
+static inline void des_bs_transpose64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL, t;
+
+    for (int j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (int i = 0; i < 64; i = ((i | j) + 1) & ~j) {
+            t = (a[i] ^ (a[i | j] >> j)) & m;
+            a[i] ^= t;
+            a[i | j] ^= t << j;
+        }
+    }
+}
+
+// Claves de un lote en forma bitsliced: k[n][w] tiene el bit DES n+1 de las claves de los
+// carriles 64*w .. 64*w+63. base/count recuerdan el último rango cargado con
+// des_bs_keys_load() para poder actualizarlo de forma incremental.
+typedef struct {
+    uint64_t k[64][DES_BS_LANES / 64] __attribute__((aligned(64)));
+    long base;
+    int count;
+} des_bs_keys;
+
+// Posición DES (0..63) de cada bit del valor entero de la clave, o -1 si el bit no afecta
+// a la clave (paridad). Se calcula en des_bs_set_keymap() a partir de la conversión
+// clave -> DES_cblock de cada programa, que debe ser una permutación de bits.
+static signed char des_bs_keymap[64];
+static int des_bs_width = 64;
+
+// Posiciones DES (bit n = posición n) fijas a 1 en todas las claves, y conversión valor ->
+// clave para los valores que no son una permutación de bits (des_mask.h). Por defecto no hay.
+static uint64_t des_bs_fixed;
+static void (*des_bs_key_fn)(long value, DES_cblock *keyblock);
+
+static inline void des_bs_set_fixed(uint64_t positions) {
+    des_bs_fixed = positions;
+}
+
+// Con una conversión propia cada lote se convierte clave a clave (transposición completa)
+static inline void des_bs_set_key_fn(void (*to_block)(long value, DES_cblock *keyblock)) {
+    des_bs_key_fn = to_block;
+}
+
+static inline void des_bs_set_keymap(void (*to_block)(long key, DES_cblock *keyblock)) {
+    for (int b = 0; b < 64; b++) {
+        DES_cblock kb;
+        des_bs_keymap[b] = -1;
+        to_block((long)(1UL << b), &kb);
+        for (int n = 0; n < 64; n++) {
+            if ((n & 7) != 7 && ((kb[n >> 3] >> (7 - (n & 7))) & 1)) des_bs_keymap[b] = n;
+        }
+    }
+}
+
+static inline void des_bs_keys_init(des_bs_keys *ks) {
+    ks->count = 0;
+}
+
+// Carga un lote arbitrario de claves ya convertidas a DES_cblock (transposición completa).
+static inline void des_bs_keys_from_blocks(des_bs_keys *ks, const DES_cblock *keys, int count) {
+    uint64_t rows[64];
+
+    for (int w = 0; w < DES_BS_LANES / 64; w++) {
+        memset(rows, 0, sizeof(rows));
+        for (int i = 0; i < 64 && 64 * w + i < count; i++) {
+            uint64_t row = 0;
+            for (int b = 0; b < 8; b++) row = (row << 8) | keys[64 * w + i][b];
+            rows[63 - i] = row;   // fila 63-i = clave del carril i, bit 63 = bit DES 1
+        }
+        if (64 * w < count) des_bs_transpose64(rows);
+        for (int n = 0; n < 64; n++) ks->k[n][w] = rows[n];
+    }
+    ks->count = -1;   // no es un rango: la próxima carga será completa
+}
+
+// Invierte en todos los carriles el bit b del valor de la clave
+static inline void des_bs_keys_flip(des_bs_keys *ks, int b) {
+    int n = des_bs_keymap[b];
+    if (n < 0) return;
+    for (int w = 0; w < des_bs_width / 64; w++) ks->k[n][w] = ~ks->k[n][w];
+}
+
+// Carga las claves base .. base+count-1 (count <= des_bs_lanes()). Si el lote está alineado
+// y el anterior también, solo se invierten los bits que cambiaron de base: recorriendo los
+// lotes en orden Gray (des_gray.h) es un único bit, o sea, una negación por lote.
+static inline void des_bs_keys_load(des_bs_keys *ks, long base, int count) {
+    int lanes = des_bs_width, lane_bits = __builtin_ctz(des_bs_width);
+    int aligned = count == lanes && (base & (lanes - 1)) == 0;
+
+    if (des_bs_key_fn) {
+        DES_cblock keys[DES_BS_LANES];
+        for (int i = 0; i < count; i++) des_bs_key_fn(base + i, &keys[i]);
+        des_bs_keys_from_blocks(ks, keys, count);
+        return;
+    }
+
+    if (aligned && ks->count == lanes) {
+        unsigned long diff = (unsigned long)(base ^ ks->base);
+        while (diff) {
+            des_bs_keys_flip(ks, __builtin_ctzl(diff));
+            diff &= diff - 1;
+        }
+    } else if (aligned) {
+        // Bits bajos: patrón fijo por carril; bits altos: constantes en todo el lote
+        static const uint64_t pattern[6] = {
+            0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+            0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+        };
+        memset(ks->k, 0, sizeof(ks->k));
+        for (int b = 0; b < 64; b++) {
+            int n = des_bs_keymap[b];
+            if (n < 0) continue;
+            for (int w = 0; w < lanes / 64; w++) {
+                if (b < 6) ks->k[n][w] = pattern[b];
+                else if (b < lane_bits) ks->k[n][w] = ((w >> (b - 6)) & 1) ? ~0ULL : 0;
+                else ks->k[n][w] = ((base >> b) & 1) ? ~0ULL : 0;
+            }
+        }
+        for (int n = 0; n < 64; n++) {
+            if ((des_bs_fixed >> n) & 1) {
+                for (int w = 0; w < lanes / 64; w++) ks->k[n][w] = ~0ULL;
+            }
+        }
+    } else {
+        DES_cblock keys[DES_BS_LANES];
+        for (int i = 0; i < count; i++) {
+            memset(keys[i], 0, sizeof(DES_cblock));
+            for (int n = 0; n < 64; n++) {
+                if ((des_bs_fixed >> n) & 1) keys[i][n >> 3] |= 0x80 >> (n & 7);
+            }
+            for (int b = 0; b < 64; b++) {
+                int n = des_bs_keymap[b];
+                if (n >= 0 && (((base + i) >> b) & 1)) keys[i][n >> 3] |= 0x80 >> (n & 7);
+            }
+        }
+        // Lote desalineado: des_bs_keys_from_blocks deja count = -1 y el siguiente se
+        // reconstruye entero
+        des_bs_keys_from_blocks(ks, keys, count);
+        return;
+    }
+    ks->base = base;
+    ks->count = count;
+}
+
+// Instancias del kernel
+#define DES_BS_T uint64_t
+#define DES_BS_WORDS 1
+#define DES_BS_SUFFIX 64
+#define DES_BS_ATTR
+#include "des_bs_kernel.h"
+#undef DES_BS_T
+#undef DES_BS_WORDS
+#undef DES_BS_SUFFIX
+#undef DES_BS_ATTR
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DES_BS_X86 1
+
+typedef uint64_t des_bs256_t __attribute__((vector_size(32)));
+typedef uint64_t des_bs512_t __attribute__((vector_size(64)));
+
+#define DES_BS_T des_bs256_t
+#define DES_BS_WORDS 4
+#define DES_BS_SUFFIX 256
+#define DES_BS_ATTR __attribute__((target("avx2")))
+#include "des_bs_kernel.h"
+#undef DES_BS_T
+#undef DES_BS_WORDS
+#undef DES_BS_SUFFIX
+#undef DES_BS_ATTR
+
+#define DES_BS_T des_bs512_t
+#define DES_BS_WORDS 8
+#define DES_BS_SUFFIX 512
+#define DES_BS_ATTR __attribute__((target("avx512f")))
+#include "des_bs_kernel.h"
+#undef DES_BS_T
+#undef DES_BS_WORDS
+#undef DES_BS_SUFFIX
+#undef DES_BS_ATTR
+#endif
+
+// Kernel activo, elegido en des_bs_init()
+typedef int (*des_bs_candidates_fn)(const des_bs_keys *, int, const unsigned char *,
+                                    const unsigned char *, uint64_t *);
+
+typedef int (*des_bs_match_fn)(const des_bs_keys *, int, const unsigned char *, int,
+                               const unsigned char (*)[8], int, const unsigned char *,
+                               uint64_t (*)[DES_BS_LANES / 64]);
+
+static const char *des_bs_kernel_name = "64 bits (portable)";
+static des_bs_candidates_fn des_bs_candidates_active = des_bs_candidates_64;
+static des_bs_match_fn des_bs_match_active = des_bs_match_64;
+
+typedef void (*des_bs_crypt_lanes_fn)(const des_bs_keys *, const unsigned char *, int, uint64_t *);
+static des_bs_crypt_lanes_fn des_bs_crypt_lanes_active = des_bs_crypt_lanes_64;
+
+// Anchos disponibles en esta CPU, de mayor a menor (respetando DES_BS_WIDTH)
+static inline int des_bs_supported(int width) {
+    const char *limit = getenv("DES_BS_WIDTH");
+    if (limit && width > atoi(limit)) return 0;
+    if (width == 64) return 1;
+#ifdef DES_BS_X86
+    __builtin_cpu_init();
+    if (width == 256) return __builtin_cpu_supports("avx2");
+    if (width == 512) return __builtin_cpu_supports("avx512f");
+#endif
+    return 0;
+}
+
+static inline void des_bs_init(void) {
+    des_key_schedule_bits(des_bs_ks);
+    des_sp_init();   // DES escalar de la verificación
+
+#ifdef DES_BS_X86
+    if (des_bs_supported(512)) {
+        des_bs_width = 512;
+        des_bs_kernel_name = "AVX-512";
+        des_bs_candidates_active = des_bs_candidates_512;
+        des_bs_match_active = des_bs_match_512;
+        des_bs_crypt_lanes_active = des_bs_crypt_lanes_512;
+    } else if (des_bs_supported(256)) {
+        des_bs_width = 256;
+        des_bs_kernel_name = "AVX2";
+        des_bs_candidates_active = des_bs_candidates_256;
+        des_bs_match_active = des_bs_match_256;
+        des_bs_crypt_lanes_active = des_bs_crypt_lanes_256;
+    }
+#endif
+}
+
+// Carriles del kernel activo: los lotes de tryKeys deben tener como máximo este tamaño
+static inline int des_bs_lanes(void) {
+    return des_bs_width;
+}
+
+// Descifra el primer bloque con las `count` claves de ks (count <= des_bs_lanes()) y deja
+// en mask (des_bs_lanes()/64 palabras) los carriles que pasan el filtro de texto: bit i
+// de la palabra w corresponde al carril 64*w + i. Devuelve 0 si no hay candidatos.
+static inline int des_bs_candidates(const des_bs_keys *ks, int count,
+                                    const unsigned char *ciph, uint64_t *mask) {
+    return des_bs_candidates_active(ks, count, ciph, NULL, mask);
+}
+
+// Igual para CBC: el filtro de texto se aplica a D(C0) ^ iv (iv = NULL equivale a ECB)
+static inline int des_bs_candidates_iv(const des_bs_keys *ks, int count, const unsigned char *ciph,
+                                       const unsigned char *iv, uint64_t *mask) {
+    return des_bs_candidates_active(ks, count, ciph, iv, mask);
+}
+
+// Todos los carriles del lote, sin filtro: los `count` primeros bits de mask. Devuelve count > 0.
+static inline int des_bs_all(int count, uint64_t *mask) {
+    for (int w = 0; w < des_bs_lanes() / 64; w++) {
+        int lanes = count - 64 * w;
+        mask[w] = lanes <= 0 ? 0 : lanes < 64 ? (1ULL << lanes) - 1 : ~0ULL;
+    }
+    return count > 0;
+}
+
+// Cifra (enc=1) o descifra (enc=0) el bloque `in` con las `count` claves de ks y marca en
+// mask[t] los carriles cuyo resultado es igual a target[t] (t < ntargets). Si care no es
+// NULL solo se comparan los bits a 1 de care (prefijos de menos de 8 bytes).
+// Devuelve 0 si no coincide ninguno.
+static inline int des_bs_match(const des_bs_keys *ks, int count, const unsigned char *in,
+                               int enc, const unsigned char (*target)[8], int ntargets,
+                               const unsigned char *care, uint64_t (*mask)[DES_BS_LANES / 64]) {
+    return des_bs_match_active(ks, count, in, enc, target, ntargets, care, mask);
+}
+
+// Cifra (enc=1) o descifra (enc=0) el bloque `in` con todas las claves de ks y deja el
+// resultado de cada carril en out[lane] (des_bs_lanes() valores, byte 0 en los bits altos)
+static inline void des_bs_crypt_lanes(const des_bs_keys *ks, const unsigned char *in, int enc,
+                                      uint64_t *out) {
+    des_bs_crypt_lanes_active(ks, in, enc, out);
+}
+
+// Verificación cruzada contra OpenSSL del DES escalar y de todos los kernels bitsliced que
+// soporta la CPU.
+// Devuelve 1 si todo coincide.
+static inline int des_bs_selftest(void) {
+    if (!des_sp_selftest()) return 0;
+    if (!des_bs_selftest_64()) return 0;
+#ifdef DES_BS_X86
+    if (des_bs_supported(256) && !des_bs_selftest_256()) return 0;
+    if (des_bs_supported(512) && !des_bs_selftest_512()) return 0;
+#endif
+    return 1;
+}
+
+#endif
@@ -0,0 +1,198 @@
+// Cuerpo del kernel DES bitsliced. No tiene include guard: des_bs.h lo incluye una vez por
+// ancho de carril definiendo DES_BS_T (tipo de una variable bitsliced), DES_BS_WORDS
+// (palabras de 64 bits en DES_BS_T), DES_BS_SUFFIX (sufijo de los nombres) y DES_BS_ATTR
+// (atributo target para compilar con AVX2/AVX-512 sin depender de -march).
+
+DES_BS_SBOX(0) DES_BS_SBOX(1) DES_BS_SBOX(2) DES_BS_SBOX(3)
+DES_BS_SBOX(4) DES_BS_SBOX(5) DES_BS_SBOX(6) DES_BS_SBOX(7)
+
+// Copia las claves de ks (filas de 64*DES_BS_WORDS carriles) a variables del kernel
+DES_BS_ATTR static inline void DES_BS_FN(des_bs_load_keys)(const des_bs_keys *ks, DES_BS_T k[64]) {
+    for (int n = 0; n < 64; n++) {
+        memcpy(&k[n], ks->k[n], sizeof(DES_BS_T));
+    }
+}
+
+// Cifra (enc=1) o descifra (enc=0) el mismo bloque con todas las claves de k.
+// out[n] queda con el bit DES n+1 del resultado de cada carril.
+DES_BS_ATTR static inline void DES_BS_FN(des_bs_crypt)(const DES_BS_T k[64],
+                                                       const unsigned char in[8], int enc,
+                                                       DES_BS_T out[64]) {
+    DES_BS_T lr[2][32], e[48], o[32];
+    DES_BS_T *L = lr[0], *R = lr[1];
+    DES_BS_T zero = {0}, ones = ~zero;
+
+    for (int i = 0; i < 64; i++) {
+        int n = des_ip[i] - 1;
+        DES_BS_T bit = ((in[n >> 3] >> (7 - (n & 7))) & 1) ? ones : zero;
+        if (i < 32) L[i] = bit; else R[i - 32] = bit;
+    }
+
+    for (int round = 0; round < 16; round++) {
+        const unsigned char *ks = des_bs_ks[enc ? round : 15 - round];
+        for (int j = 0; j < 48; j++) {
+            e[j] = R[des_e[j] - 1] ^ k[ks[j]];
+        }
+        DES_BS_FN(des_bs_sbox0)(e,      o);
+        DES_BS_FN(des_bs_sbox1)(e +  6, o +  4);
+        DES_BS_FN(des_bs_sbox2)(e + 12, o +  8);
+        DES_BS_FN(des_bs_sbox3)(e + 18, o + 12);
+        DES_BS_FN(des_bs_sbox4)(e + 24, o + 16);
+        DES_BS_FN(des_bs_sbox5)(e + 30, o + 20);
+        DES_BS_FN(des_bs_sbox6)(e + 36, o + 24);
+        DES_BS_FN(des_bs_sbox7)(e + 42, o + 28);
+        for (int i = 0; i < 32; i++) {
+            L[i] ^= o[des_p[i] - 1];
+        }
+        DES_BS_T *t = L; L = R; R = t;
+    }
+
+    // Salida = FP(R16 L16)
+    for (int i = 0; i < 64; i++) {
+        out[des_ip[i] - 1] = (i < 32) ? R[i] : L[i - 32];
+    }
+}
+
+// Máscara de carriles cuyo bloque (8 bytes bitsliced) es texto con el criterio de
+// des_text_block() (des_verify.h): sin bytes de control salvo \t \n \r, ni 0x7F; los bytes
+// >= 0x80 se aceptan (UTF-8).
+DES_BS_ATTR static inline DES_BS_T DES_BS_FN(des_bs_text_mask)(const DES_BS_T p[64]) {
+    DES_BS_T zero = {0}, mask = ~zero;
+
+    for (int b = 0; b < 8; b++) {
+        const DES_BS_T *x = p + 8 * b;   // x[0] = bit 7 ... x[7] = bit 0
+        DES_BS_T high = x[0];            // 0x80-0xFF
+        DES_BS_T printable = ~x[0] & (x[1] | x[2]) &
+                             ~(x[1] & x[2] & x[3] & x[4] & x[5] & x[6] & x[7]);
+        DES_BS_T space = ~x[0] & ~x[1] & ~x[2] & ~x[3] & x[4] &
+                         ((~x[5] & ~x[6] & x[7]) |    // 0x09
+                          (~x[5] & x[6] & ~x[7]) |    // 0x0A
+                          (x[5] & ~x[6] & x[7]));     // 0x0D
+        mask &= high | printable | space;
+    }
+    return mask;
+}
+
+DES_BS_ATTR static inline int DES_BS_FN(des_bs_candidates)(const des_bs_keys *ks, int count,
+                                                           const unsigned char *ciph,
+                                                           const unsigned char *iv,
+                                                           uint64_t *mask) {
+    DES_BS_T k[64], p[64], m;
+    int any = 0;
+
+    DES_BS_FN(des_bs_load_keys)(ks, k);
+    DES_BS_FN(des_bs_crypt)(k, ciph, 0, p);
+
+    // CBC: P0 = D(C0) ^ IV; con IV constante en todos los carriles es negar filas
+    if (iv) {
+        for (int b = 0; b < 64; b++) {
+            if ((iv[b / 8] >> (7 - b % 8)) & 1) p[b] = ~p[b];
+        }
+    }
+    m = DES_BS_FN(des_bs_text_mask)(p);
+    memcpy(mask, &m, sizeof(m));
+
+    for (int w = 0; w < DES_BS_WORDS; w++) {
+        int lanes = count - 64 * w;
+        if (lanes <= 0) mask[w] = 0;
+        else if (lanes < 64) mask[w] &= (1ULL << lanes) - 1;
+        any |= mask[w] != 0;
+    }
+    return any;
+}
+
+// Cifra (enc=1) o descifra (enc=0) `in` con las claves de ks y deja en mask[t] los carriles
+// cuyo resultado es igual a target[t] en los bits marcados en care (NULL = los 64 bits).
+// Devuelve 0 si ningún carril coincide.
+DES_BS_ATTR static inline int DES_BS_FN(des_bs_match)(const des_bs_keys *ks, int count,
+                                                      const unsigned char in[8], int enc,
+                                                      const unsigned char (*target)[8],
+                                                      int ntargets, const unsigned char *care,
+                                                      uint64_t (*mask)[DES_BS_LANES / 64]) {
+    DES_BS_T k[64], out[64], zero = {0};
+    int any = 0;
+
+    DES_BS_FN(des_bs_load_keys)(ks, k);
+    DES_BS_FN(des_bs_crypt)(k, in, enc, out);
+
+    for (int t = 0; t < ntargets; t++) {
+        DES_BS_T eq = ~zero;
+        for (int n = 0; n < 64; n++) {
+            if (care && !((care[n >> 3] >> (7 - (n & 7))) & 1)) continue;
+            eq &= ((target[t][n >> 3] >> (7 - (n & 7))) & 1) ? out[n] : ~out[n];
+        }
+        memcpy(mask[t], &eq, sizeof(eq));
+        for (int w = 0; w < DES_BS_WORDS; w++) {
+            int lanes = count - 64 * w;
+            if (lanes <= 0) mask[t][w] = 0;
+            else if (lanes < 64) mask[t][w] &= (1ULL << lanes) - 1;
+            any |= mask[t][w] != 0;
+        }
+    }
+    return any;
+}
+
+// Cifra (enc=1) o descifra (enc=0) `in` con las claves de ks y devuelve el resultado de
+// cada carril como entero (out[lane], byte 0 del bloque en los bits altos)
+DES_BS_ATTR static inline void DES_BS_FN(des_bs_crypt_lanes)(const des_bs_keys *ks,
+                                                             const unsigned char in[8], int enc,
+                                                             uint64_t *out) {
+    DES_BS_T k[64], bits[64];
+    uint64_t flat[64][DES_BS_WORDS], rows[64];
+
+    DES_BS_FN(des_bs_load_keys)(ks, k);
+    DES_BS_FN(des_bs_crypt)(k, in, enc, bits);
+    memcpy(flat, bits, sizeof(flat));
+
+    for (int w = 0; w < DES_BS_WORDS; w++) {
+        for (int n = 0; n < 64; n++) rows[n] = flat[n][w];
+        des_bs_transpose64(rows);
+        for (int i = 0; i < 64; i++) out[64 * w + i] = rows[63 - i];
+    }
+}
+
+// Cifra y descifra bloques pseudoaleatorios con claves pseudoaleatorias y compara cada
+// carril con DES_ecb_encrypt de OpenSSL. Devuelve 1 si todo coincide.
+DES_BS_ATTR static inline int DES_BS_FN(des_bs_selftest)(void) {
+    DES_cblock keys[64 * DES_BS_WORDS];
+    des_bs_keys ks;
+    DES_key_schedule schedule;
+    unsigned char block[8], ref[8];
+    DES_BS_T k[64], out[64];
+    uint64_t bits[DES_BS_WORDS], values[64 * DES_BS_WORDS];
+    uint64_t seed = 0x243F6A8885A308D3ULL;
+
+    for (int lane = 0; lane < 64 * DES_BS_WORDS; lane++) {
+        for (int b = 0; b < 8; b++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            keys[lane][b] = (unsigned char)(seed >> 56);
+        }
+    }
+    des_bs_keys_from_blocks(&ks, keys, 64 * DES_BS_WORDS);
+    DES_BS_FN(des_bs_load_keys)(&ks, k);
+
+    for (int test = 0; test < 4; test++) {
+        for (int b = 0; b < 8; b++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            block[b] = (unsigned char)(seed >> 56);
+        }
+        int enc = test & 1;
+        DES_BS_FN(des_bs_crypt)(k, block, enc, out);
+        DES_BS_FN(des_bs_crypt_lanes)(&ks, block, enc, values);
+
+        for (int lane = 0; lane < 64 * DES_BS_WORDS; lane++) {
+            DES_set_key_unchecked(&keys[lane], &schedule);
+            DES_ecb_encrypt((DES_cblock *)block, (DES_cblock *)ref, &schedule,
+                            enc ? DES_ENCRYPT : DES_DECRYPT);
+            for (int n = 0; n < 64; n++) {
+                memcpy(bits, &out[n], sizeof(bits));
+                int bit = (int)((bits[lane >> 6] >> (lane & 63)) & 1);
+                if (bit != ((ref[n >> 3] >> (7 - (n & 7))) & 1)) return 0;
+            }
+            uint64_t value = 0;
+            for (int b = 0; b < 8; b++) value = (value << 8) | ref[b];
+            if (values[lane] != value) return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,149 @@
+#ifndef DES_CKPT_H
+#define DES_CKPT_H
+
+// Checkpoint de un barrido largo: conjunto de intervalos [lo, hi) de claves ya recorridos
+// por completo, ordenados y fusionados. Lo lleva solo el proceso 0, que sabe qué trozos
+// terminó cada trabajador (des_sched.h), y lo guarda cada DES_CKPT_SECONDS en un archivo de
+// texto pequeño: no hay operaciones colectivas, así que los demás procesos no esperan.
+// Al reanudar (--resume) el reparto salta los intervalos cubiertos; como solo se guardan
+// rangos de claves, se puede reanudar con otro número de procesos.
+//
+// Formato:
+//   des-ckpt 1 <modo> <semilla>   (modo: 0 normal, 1 complemento, no se mezclan;
+//                                  semilla de --shuffle, 0 = orden natural)
+//   <lo> <hi>                     un intervalo recorrido por línea
+//
+// Con --shuffle los intervalos son del espacio virtual que reparte des_sched, por eso la
+// semilla va en el archivo: al reanudar se usa la misma.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define DES_CKPT_SECONDS 60.0   // tiempo entre escrituras
+
+typedef struct {
+    long *lo, *hi;
+    int n, cap;
+    int mode;
+    unsigned long seed;
+    double last_write;
+} des_ckpt_t;
+
+static inline void des_ckpt_init(des_ckpt_t *c, int mode) {
+    memset(c, 0, sizeof(*c));
+    c->mode = mode;
+}
+
+static inline void des_ckpt_free(des_ckpt_t *c) {
+    free(c->lo);
+    free(c->hi);
+    c->lo = c->hi = NULL;
+    c->n = c->cap = 0;
+}
+
+// Agrega [a, b) fusionando con los vecinos. Devuelve 0 si no hay memoria.
+static inline int des_ckpt_add(des_ckpt_t *c, long a, long b) {
+    int i, j;
+
+    if (a >= b) return 1;
+    // Primer intervalo que termina en a o después: los anteriores no se tocan
+    for (i = 0; i < c->n && c->hi[i] < a; i++) { }
+    // Intervalos que se solapan o son contiguos con [a, b)
+    for (j = i; j < c->n && c->lo[j] <= b; j++) {
+        if (c->lo[j] < a) a = c->lo[j];
+        if (c->hi[j] > b) b = c->hi[j];
+    }
+    if (j == i) {
+        if (c->n == c->cap) {
+            int cap = c->cap ? 2 * c->cap : 16;
+            long *lo = realloc(c->lo, cap * sizeof(long));
+            if (!lo) return 0;
+            c->lo = lo;
+            long *hi = realloc(c->hi, cap * sizeof(long));
+            if (!hi) return 0;
+            c->hi = hi;
+            c->cap = cap;
+        }
+        memmove(c->lo + i + 1, c->lo + i, (c->n - i) * sizeof(long));
+        memmove(c->hi + i + 1, c->hi + i, (c->n - i) * sizeof(long));
+        c->n++;
+    } else if (j > i + 1) {
+        memmove(c->lo + i + 1, c->lo + j, (c->n - j) * sizeof(long));
+        memmove(c->hi + i + 1, c->hi + j, (c->n - j) * sizeof(long));
+        c->n -= j - i - 1;
+    }
+    c->lo[i] = a;
+    c->hi[i] = b;
+    return 1;
+}
+
+// Primera clave no recorrida desde key; en *limit, el inicio del siguiente intervalo
+// recorrido (LONG_MAX si no hay)
+static inline long des_ckpt_skip(const des_ckpt_t *c, long key, long *limit) {
+    int i;
+
+    for (i = 0; i < c->n && c->hi[i] <= key; i++) { }
+    if (i < c->n && c->lo[i] <= key) key = c->hi[i++];
+    *limit = (i < c->n) ? c->lo[i] : LONG_MAX;
+    return key;
+}
+
+// Claves recorridas dentro de [0, end)
+static inline long des_ckpt_covered(const des_ckpt_t *c, long end) {
+    long total = 0;
+    for (int i = 0; i < c->n && c->lo[i] < end; i++) {
+        total += (c->hi[i] < end ? c->hi[i] : end) - c->lo[i];
+    }
+    return total;
+}
+
+// Devuelve 0 si el archivo no existe, no tiene el formato o es de otro modo. La semilla
+// del archivo queda en c->seed.
+static inline int des_ckpt_load(des_ckpt_t *c, const char *path) {
+    FILE *f = fopen(path, "r");
+    int version, mode;
+    long a, b;
+
+    if (!f) return 0;
+    if (fscanf(f, "des-ckpt %d %d %lu", &version, &mode, &c->seed) != 3 || version != 1 ||
+        mode != c->mode) {
+        fclose(f);
+        return 0;
+    }
+    while (fscanf(f, "%ld %ld", &a, &b) == 2) {
+        if (a < 0 || a > b || !des_ckpt_add(c, a, b)) {
+            fclose(f);
+            return 0;
+        }
+    }
+    int ok = feof(f);
+    fclose(f);
+    return ok;
+}
+
+// Escribe en path.tmp y lo renombra, para que un corte a mitad de escritura deje el
+// checkpoint anterior intacto. Devuelve 0 si falla.
+static inline int des_ckpt_save(des_ckpt_t *c, const char *path) {
+    char tmp[300];
+    FILE *f;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    f = fopen(tmp, "w");
+    if (!f) return 0;
+    fprintf(f, "des-ckpt 1 %d %lu\n", c->mode, c->seed);
+    for (int i = 0; i < c->n; i++) fprintf(f, "%ld %ld\n", c->lo[i], c->hi[i]);
+    if (fclose(f) != 0) return 0;
+    return rename(tmp, path) == 0;
+}
+
+// Guarda si pasaron DES_CKPT_SECONDS desde la última escritura (now = MPI_Wtime())
+static inline int des_ckpt_tick(des_ckpt_t *c, const char *path, double now) {
+    if (c->last_write == 0) c->last_write = now;
+    if (now - c->last_write < DES_CKPT_SECONDS) return 1;
+    c->last_write = now;
+    return des_ckpt_save(c, path);
+}
+
+#endif
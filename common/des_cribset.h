@@ -0,0 +1,125 @@
+#ifndef DES_CRIBSET_H
+#define DES_CRIBSET_H
+
+// Búsqueda de la frase por bloques cifrados. En ECB, si la frase aparece en la posición p
+// del texto, el fragmento de 8 bytes que empieza en el primer múltiplo de 8 >= p es un
+// bloque completo del texto en claro. Con una frase de 15 bytes o más ese fragmento existe
+// para las 8 alineaciones posibles, así que basta cifrar esos (<= 8) fragmentos con cada
+// clave y buscar el resultado en el conjunto de bloques del texto cifrado. El coste por
+// clave no depende de la longitud del mensaje ni de que el primer bloque sea texto.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DES_CRIBSET_MIN 15   // longitud mínima de la frase para cubrir las 8 alineaciones
+
+// Tabla de bloques de 64 bits (direccionamiento abierto). Cada entrada recuerda de qué
+// mensaje salió (owner), así una sola consulta sirve para varios objetivos.
+typedef struct {
+    uint64_t *value;
+    int *owner;        // -1 = libre
+    uint64_t mask;
+    int count;
+} des_blocktab_t;
+
+static inline uint64_t des_block_load(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline uint64_t des_block_hash(uint64_t v) {
+    return (v * 0x9E3779B97F4A7C15ULL) >> 17;
+}
+
+// Reserva espacio para `capacity` bloques. Devuelve 0 si no hay memoria.
+static inline int des_blocktab_init(des_blocktab_t *t, int capacity) {
+    uint64_t size = 16;
+    while (size < 2 * (uint64_t)capacity) size <<= 1;
+    t->value = malloc(size * sizeof(uint64_t));
+    t->owner = malloc(size * sizeof(int));
+    t->mask = size - 1;
+    t->count = 0;
+    if (!t->value || !t->owner) {
+        free(t->value);
+        free(t->owner);
+        t->value = NULL;
+        t->owner = NULL;
+        return 0;
+    }
+    for (uint64_t i = 0; i < size; i++) t->owner[i] = -1;
+    return 1;
+}
+
+// Añade (v, owner) si no estaba ya; el mismo bloque puede tener varios dueños
+static inline void des_blocktab_add(des_blocktab_t *t, uint64_t v, int owner) {
+    uint64_t h = des_block_hash(v) & t->mask;
+    while (t->owner[h] >= 0) {
+        if (t->value[h] == v && t->owner[h] == owner) return;
+        h = (h + 1) & t->mask;
+    }
+    t->value[h] = v;
+    t->owner[h] = owner;
+    t->count++;
+}
+
+// Recorre las entradas con valor v: slot = des_blocktab_find(t, v, -1), luego
+// des_blocktab_find(t, v, slot) hasta que devuelva -1
+static inline long des_blocktab_find(const des_blocktab_t *t, uint64_t v, long slot) {
+    uint64_t h = (slot < 0) ? (des_block_hash(v) & t->mask) : (((uint64_t)slot + 1) & t->mask);
+    while (t->owner[h] >= 0) {
+        if (t->value[h] == v) return (long)h;
+        h = (h + 1) & t->mask;
+    }
+    return -1;
+}
+
+static inline void des_blocktab_free(des_blocktab_t *t) {
+    free(t->value);
+    free(t->owner);
+    t->value = NULL;
+    t->owner = NULL;
+}
+
+typedef struct {
+    unsigned char chunk[8][8];   // fragmentos alineados distintos de la frase
+    int nchunks;
+    des_blocktab_t blocks;       // bloques de los textos cifrados
+} des_cribset_t;
+
+// Prepara los fragmentos de la frase y la tabla para `capacity` bloques cifrados.
+// Devuelve 0 si la frase es demasiado corta o no hay memoria.
+static inline int des_cribset_init(des_cribset_t *cs, const unsigned char *crib, int crib_len,
+                                   int capacity) {
+    memset(cs, 0, sizeof(*cs));
+    if (crib_len < DES_CRIBSET_MIN) return 0;
+
+    for (int align = 0; align < 8; align++) {
+        const unsigned char *c = crib + ((8 - align) & 7);
+        int dup = 0;
+        for (int j = 0; j < cs->nchunks; j++) {
+            if (memcmp(cs->chunk[j], c, 8) == 0) dup = 1;
+        }
+        if (!dup) memcpy(cs->chunk[cs->nchunks++], c, 8);
+    }
+    return des_blocktab_init(&cs->blocks, capacity);
+}
+
+// Añade todos los bloques de ciph (len múltiplo de 8) como pertenecientes a owner
+static inline void des_cribset_add(des_cribset_t *cs, const unsigned char *ciph, int len,
+                                   int owner) {
+    for (int i = 0; i + 8 <= len; i += 8) {
+        des_blocktab_add(&cs->blocks, des_block_load(ciph + i), owner);
+    }
+}
+
+static inline int des_cribset_has(const des_cribset_t *cs, uint64_t v) {
+    return des_blocktab_find(&cs->blocks, v, -1) >= 0;
+}
+
+static inline void des_cribset_free(des_cribset_t *cs) {
+    des_blocktab_free(&cs->blocks);
+}
+
+#endif
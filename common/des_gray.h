@@ -0,0 +1,86 @@
+#ifndef DES_GRAY_H
+#define DES_GRAY_H
+
+// Recorrido de un rango de claves [lo, hi) en lotes de `lanes` claves (potencia de 2),
+// ordenando los lotes alineados en código Gray: dos lotes seguidos difieren en un solo bit
+// de la clave base, y des_bs_keys_load() los carga con una única negación por lote.
+//
+// El rango se recorre como: lote parcial inicial (hasta el primer múltiplo de lanes),
+// bloques alineados de 2^j lotes en orden Gray, y lote parcial final. Cada clave del rango
+// aparece exactamente una vez.
+
+typedef struct {
+    long lo, hi;          // rango total
+    long first, last;     // lotes alineados completos: índices [first, last)
+    long block, size;     // bloque Gray actual: lotes [block, block + size)
+    long i;               // posición dentro del bloque
+    int lanes;
+    int stage;            // 0 = lote inicial, 1 = lotes Gray, 2 = lote final, 3 = fin
+} des_gray_t;
+
+static inline void des_gray_init(des_gray_t *g, long lo, long hi, int lanes) {
+    g->lo = lo;
+    g->hi = hi;
+    g->lanes = lanes;
+    g->first = (lo + lanes - 1) / lanes;
+    g->last = hi / lanes;
+    g->block = g->first;
+    g->size = 0;
+    g->i = 0;
+    g->stage = 0;
+}
+
+// Bloque alineado de 2^j lotes más grande que empieza en p y no pasa de end
+static inline long des_gray_block_size(long p, long end) {
+    long size = p ? (p & -p) : (1L << 62);
+    while (size > end - p) size >>= 1;
+    return size;
+}
+
+// Siguiente lote del recorrido. Devuelve 0 cuando ya no quedan claves.
+static inline int des_gray_next(des_gray_t *g, long *base, int *count) {
+    long lo, hi;
+
+    switch (g->stage) {
+    case 0:
+        g->stage = 1;
+        lo = g->lo;
+        hi = g->first * g->lanes;
+        if (hi > g->hi) hi = g->hi;
+        if (lo < hi) {
+            *base = lo;
+            *count = (int)(hi - lo);
+            return 1;
+        }
+        /* fallthrough */
+    case 1:
+        if (g->i == g->size) {
+            g->block += g->size;
+            g->i = 0;
+            g->size = (g->block < g->last) ? des_gray_block_size(g->block, g->last) : 0;
+            if (g->size == 0) g->block = g->last;
+        }
+        if (g->size) {
+            long batch = g->block ^ (g->i ^ (g->i >> 1));
+            g->i++;
+            *base = batch * g->lanes;
+            *count = g->lanes;
+            return 1;
+        }
+        g->stage = 2;
+        /* fallthrough */
+    case 2:
+        g->stage = 3;
+        lo = (g->first <= g->last) ? g->last * g->lanes : g->hi;
+        if (lo < g->hi) {
+            *base = lo;
+            *count = (int)(g->hi - lo);
+            return 1;
+        }
+        /* fallthrough */
+    default:
+        return 0;
+    }
+}
+
+#endif
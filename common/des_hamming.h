@@ -0,0 +1,73 @@
+#ifndef DES_HAMMING_H
+#define DES_HAMMING_H
+
+// Vecindario de Hamming de una pista: claves que difieren de ella en exactamente d de los 56
+// bits efectivos (la "capa" d, C(56, d) claves). Sirve para filtraciones parciales de la
+// clave (bits invertidos por fallos, canal lateral ruidoso, hexadecimal mal copiado), donde
+// la clave real está a pocos bits de la pista y no a poca distancia numérica.
+//
+// Las máscaras de una capa se numeran en orden creciente (sistema combinatorio): la máscara
+// número r se obtiene directamente (des_hamming_unrank) y la siguiente con el truco de Gosper
+// (des_hamming_next). Cada proceso calcula su tramo de la capa (des_hamming_slice) y salta a
+// su principio sin coordinarse con los demás.
+
+#include <stdint.h>
+
+#define DES_HAMMING_BITS 56
+
+static uint64_t des_hamming_binom[DES_HAMMING_BITS + 1][DES_HAMMING_BITS + 1];
+
+static inline void des_hamming_init(void) {
+    for (int n = 0; n <= DES_HAMMING_BITS; n++) {
+        des_hamming_binom[n][0] = 1;
+        for (int k = 1; k <= n; k++) {
+            des_hamming_binom[n][k] = des_hamming_binom[n - 1][k - 1] +
+                                      (k < n ? des_hamming_binom[n - 1][k] : 0);
+        }
+    }
+}
+
+// Claves en la capa d
+static inline uint64_t des_hamming_count(int d) {
+    return des_hamming_binom[DES_HAMMING_BITS][d];
+}
+
+// Máscara número r (0 <= r < C(56, d)) de la capa d
+static inline uint64_t des_hamming_unrank(int d, uint64_t r) {
+    uint64_t mask = 0;
+    int c = DES_HAMMING_BITS - 1;
+
+    for (int i = d; i > 0; i--) {
+        // Mayor c con C(c, i) <= r
+        while (des_hamming_binom[c][i] > r) c--;
+        mask |= 1ULL << c;
+        r -= des_hamming_binom[c][i];
+        c--;
+    }
+    return mask;
+}
+
+// Siguiente máscara con los mismos bits en 1 (truco de Gosper)
+static inline uint64_t des_hamming_next(uint64_t mask) {
+    if (mask == 0) return 0;
+    uint64_t low = mask & -mask;
+    uint64_t ripple = mask + low;
+    return ripple | (((mask ^ ripple) >> 2) / low);
+}
+
+// Tramo [*first, *first + *count) de la capa d que le toca a la parte `part` de `parts`
+static inline void des_hamming_slice(int d, int part, int parts, uint64_t *first, uint64_t *count) {
+    uint64_t total = des_hamming_count(d);
+    uint64_t lo = total / parts * part + (total % parts < (uint64_t)part ? total % parts : (uint64_t)part);
+    uint64_t hi = total / parts * (part + 1) +
+                  (total % parts < (uint64_t)part + 1 ? total % parts : (uint64_t)part + 1);
+
+    *first = lo;
+    *count = hi - lo;
+}
+
+static inline int des_hamming_distance(long a, long b) {
+    return __builtin_popcountl((unsigned long)(a ^ b));
+}
+
+#endif
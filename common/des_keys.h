@@ -0,0 +1,61 @@
+#ifndef DES_KEYS_H
+#define DES_KEYS_H
+
+// Numeración canónica de las claves DES, común a todos los programas.
+//
+// DES usa 56 bits de clave: el bit bajo de cada byte del DES_cblock es paridad y no
+// afecta al cifrado. Si se copia un long completo al bloque, cada clave DES aparece 256
+// veces en [0, 2^56) y la búsqueda solo cubre 2^49 claves distintas. Aquí el índice
+// 0 .. 2^56-1 es la clave: los bits 7i .. 7i+6 del índice van a los bits 7..1 del byte i
+// y el bit 0 se fija a paridad impar. Índices distintos = claves DES distintas.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <openssl/des.h>
+
+#define DES_KEY_BITS 56
+#define DES_KEY_SPACE (1L << DES_KEY_BITS)                 // claves distintas
+#define DES_KEY_PARITY_MASK 0x0101010101010101ULL          // bits que no cuentan
+
+// Índice canónico -> bloque DES con paridad impar
+static inline void des_key_to_block(long key, DES_cblock *keyblock) {
+    for (int i = 0; i < 8; i++) {
+        unsigned char b = (unsigned char)(((key >> (7 * i)) & 0x7F) << 1);
+        (*keyblock)[i] = b | !__builtin_parity(b);
+    }
+}
+
+// Bloque DES -> índice canónico (ignora los bits de paridad)
+static inline long des_key_from_block(const DES_cblock *keyblock) {
+    long key = 0;
+    for (int i = 0; i < 8; i++) {
+        key |= (long)((*keyblock)[i] >> 1) << (7 * i);
+    }
+    return key;
+}
+
+// Clave con todos los bits complementados (propiedad E_~k(~P) = ~E_k(P))
+static inline long des_key_complement(long key) {
+    return key ^ (DES_KEY_SPACE - 1);
+}
+
+// Valida un índice leído de la línea de comandos
+static inline int des_key_valid(long key) {
+    return key >= 0 && key < DES_KEY_SPACE;
+}
+
+// Imprime la clase de equivalencia de una clave encontrada: el índice canónico, el bloque
+// DES con paridad impar y la máscara de bits que se pueden cambiar sin alterar la clave.
+static inline void des_key_print_class(FILE *out, long key) {
+    DES_cblock kb;
+    uint64_t block = 0;
+
+    des_key_to_block(key, &kb);
+    for (int i = 0; i < 8; i++) block = (block << 8) | kb[i];
+    fprintf(out, "Clave canónica: %ld (56 bits efectivos)\n", key);
+    fprintf(out, "Clave DES: %016llX (paridad impar)\n", (unsigned long long)block);
+    fprintf(out, "Clase de equivalencia: %016llX ^ cualquier subconjunto de %016llX (256 bloques)\n",
+            (unsigned long long)block, (unsigned long long)DES_KEY_PARITY_MASK);
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef DES_MASK_H
+#define DES_MASK_H
+
+// Espacio de claves con partes conocidas (--mask). La máscara fija bits de la clave, deja
+// otros libres y puede limitar bytes enteros a una clase de caracteres. Se compila a un
+// contador denso 0 .. des_mask_count()-1 que es lo que se reparte entre procesos: el trabajo
+// es proporcional a lo desconocido y no a max_key.
+//
+// Sintaxis: "bits:N" (los N bits bajos del índice libres, el resto 0: claves de exportación
+// de 40 bits, por ejemplo) u 8 especificaciones de byte, del byte 0 al 7 del DES_cblock:
+//   ?             byte libre (7 bits)
+//   ?l ?u ?d ?h ?a  minúsculas, mayúsculas, dígitos, hexadecimal, ASCII imprimible
+//   [bbbbbbb]     bits 7..1 del byte: 0, 1 o ? (libre)
+//   \xHH          byte fijo en hexadecimal
+//   c             cualquier otro carácter: byte fijo
+// El bit bajo de cada byte es paridad (des_keys.h), así que dos caracteres que solo difieren
+// en él son la misma clave: las clases se cuentan sin repetidos ('b' y 'c' valen uno).
+//
+// Contador -> clave (des_mask_key): los F bits bajos del contador van, en orden, a los bits
+// libres del índice; lo que queda es un número en base mixta con un dígito por byte con clase.
+// La parte de bits libres es lineal, así que el kernel bitsliced la carga con la misma
+// inversión de bits por lote que un rango contiguo (des_mask_bs_setup); si hay clases, cada
+// lote se convierte clave a clave.
+
+#include <string.h>
+#include <stdint.h>
+#include "des_keys.h"
+#include "des_bs.h"
+
+typedef struct {
+    int active;
+    long fixed;                   // bits del índice fijos a 1
+    int nfree;
+    signed char free[DES_KEY_BITS];   // posición en el índice de cada bit libre, de menor a mayor
+    int nclass;
+    int class_byte[8];            // byte con clase (0..7)
+    int class_n[8];               // valores distintos de la clase
+    unsigned char class_value[8][128];   // 7 bits efectivos de cada valor
+    unsigned long count;          // tamaño del contador (0 si no cabe en 2^56)
+    char spec[128];
+} des_mask_t;
+
+// Valores de 7 bits de una clase, sin repetidos. Devuelve cuántos, 0 si no es una clase.
+static inline int des_mask_class(char name, unsigned char *values) {
+    int seen[128] = {0}, n = 0;
+
+    for (int c = 0x20; c < 0x7F; c++) {
+        int in = (name == 'l' && c >= 'a' && c <= 'z') ||
+                 (name == 'u' && c >= 'A' && c <= 'Z') ||
+                 (name == 'd' && c >= '0' && c <= '9') ||
+                 (name == 'h' && ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) ||
+                 name == 'a';
+        if (in && !seen[c >> 1]) {
+            seen[c >> 1] = 1;
+            values[n++] = (unsigned char)(c >> 1);
+        }
+    }
+    return strchr("ludha", name) ? n : 0;
+}
+
+// Devuelve 0 si la máscara no tiene el formato
+static inline int des_mask_parse(des_mask_t *m, const char *spec) {
+    const char *p = spec;
+    int free_bit[DES_KEY_BITS] = {0};
+
+    memset(m, 0, sizeof(*m));
+    strncpy(m->spec, spec, sizeof(m->spec) - 1);
+
+    if (strncmp(spec, "bits:", 5) == 0) {
+        char *end;
+        long n = strtol(spec + 5, &end, 10);
+        if (*end != '\0' || n < 1 || n > DES_KEY_BITS) return 0;
+        for (int b = 0; b < n; b++) free_bit[b] = 1;
+    } else {
+        for (int byte = 0; byte < 8; byte++) {
+            int shift = 7 * byte;
+            if (*p == '\0') return 0;
+            if (p[0] == '?' && p[1] && strchr("ludha", p[1])) {
+                m->class_byte[m->nclass] = byte;
+                m->class_n[m->nclass] = des_mask_class(p[1], m->class_value[m->nclass]);
+                m->nclass++;
+                p += 2;
+            } else if (p[0] == '?') {
+                for (int b = 0; b < 7; b++) free_bit[shift + b] = 1;
+                p++;
+            } else if (p[0] == '[') {
+                for (int b = 6; b >= 0; b--) {
+                    char c = *++p;
+                    if (c == '1') m->fixed |= 1L << (shift + b);
+                    else if (c == '?') free_bit[shift + b] = 1;
+                    else if (c != '0') return 0;
+                }
+                if (*++p != ']') return 0;
+                p++;
+            } else if (p[0] == '\\' && p[1] == 'x') {
+                char hex[3] = { p[2], p[2] ? p[3] : 0, 0 };
+                char *end;
+                long value = strtol(hex, &end, 16);
+                if (!hex[0] || !hex[1] || *end != '\0') return 0;
+                m->fixed |= (value >> 1) << shift;
+                p += 4;
+            } else {
+                m->fixed |= (long)((unsigned char)*p >> 1) << shift;
+                p++;
+            }
+        }
+        if (*p != '\0') return 0;
+    }
+
+    for (int b = 0; b < DES_KEY_BITS; b++) {
+        if (free_bit[b]) m->free[m->nfree++] = (signed char)b;
+    }
+    m->count = 1UL << m->nfree;
+    for (int i = 0; i < m->nclass; i++) {
+        if (m->count > (unsigned long)DES_KEY_SPACE / m->class_n[i]) return 0;
+        m->count *= m->class_n[i];
+    }
+    m->active = 1;
+    return 1;
+}
+
+// Índice canónico de la clave número value del contador
+static inline long des_mask_key(const des_mask_t *m, long value) {
+    long key = m->fixed;
+
+    for (int j = 0; j < m->nfree; j++) {
+        key |= ((value >> j) & 1) << m->free[j];
+    }
+    unsigned long rest = (unsigned long)value >> m->nfree;
+    for (int i = 0; i < m->nclass; i++) {
+        key |= (long)m->class_value[i][rest % m->class_n[i]] << (7 * m->class_byte[i]);
+        rest /= m->class_n[i];
+    }
+    return key;
+}
+
+// Máscara activa para la conversión clave a clave del kernel bitsliced
+static des_mask_t des_mask_bs;
+
+static inline void des_mask_to_block(long value, DES_cblock *keyblock) {
+    des_key_to_block(des_mask_key(&des_mask_bs, value), keyblock);
+}
+
+// Prepara el kernel bitsliced para recibir valores del contador en vez de índices: los bits
+// libres se mapean a su posición DES y los fijos quedan constantes en todos los carriles.
+// Llamar después de des_bs_set_keymap(des_key_to_block).
+static inline void des_mask_bs_setup(const des_mask_t *m) {
+    signed char index_map[64];
+    uint64_t fixed = 0;
+
+    memcpy(index_map, des_bs_keymap, sizeof(index_map));
+    for (int b = 0; b < 64; b++) des_bs_keymap[b] = (b < m->nfree) ? index_map[(int)m->free[b]] : -1;
+    for (int b = 0; b < DES_KEY_BITS; b++) {
+        if (((m->fixed >> b) & 1) && index_map[b] >= 0) fixed |= 1ULL << index_map[b];
+    }
+    des_bs_set_fixed(fixed);
+    if (m->nclass > 0) {
+        des_mask_bs = *m;
+        des_bs_set_key_fn(des_mask_to_block);
+    }
+}
+
+// Descripción corta: bits libres y clases
+static inline void des_mask_describe(const des_mask_t *m, char *out, size_t size) {
+    int n = snprintf(out, size, "%d bits libres", m->nfree);
+    for (int i = 0; i < m->nclass && n > 0 && (size_t)n < size; i++) {
+        n += snprintf(out + n, size - n, ", byte %d: %d valores", m->class_byte[i], m->class_n[i]);
+    }
+}
+
+#endif
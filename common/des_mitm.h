@@ -0,0 +1,157 @@
+#ifndef DES_MITM_H
+#define DES_MITM_H
+
+// Meet-in-the-middle para doble DES, C = E_k2(E_k1(P)). La tabla de E_k1(P) se reparte
+// entre los procesos por hash del valor (des_mitm_owner): cada proceso calcula valores de
+// su parte del rango de claves, los agrupa por dueño y los envía en lotes con
+// MPI_Alltoallv (des_mitm_exchange). En la segunda fase los D_k2(C) se envían igual al
+// dueño, que los busca en su parte de la tabla. Si la tabla de todas las claves k1 no cabe,
+// se recorre el espacio de k1 en pasadas y en cada una se barre otra vez todo k2.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "des_cribset.h"
+
+typedef struct {
+    uint64_t value;   // E_k1(P) o D_k2(C), byte 0 en los bits altos
+    long key;
+} des_mitm_pair;
+
+// Parte local de la tabla (direccionamiento abierto, admite valores repetidos)
+typedef struct {
+    uint64_t *value;
+    long *key;        // -1 = libre
+    uint64_t mask;
+    long count, limit;
+} des_mitm_table_t;
+
+// Proceso dueño del valor v. Usa otra multiplicación que des_block_hash para que el reparto
+// no deje fijos bits del índice dentro de cada tabla local.
+static inline int des_mitm_owner(uint64_t v, int nprocs) {
+    return (int)((((v * 0xC2B2AE3D27D4EB4FULL) >> 32) * (uint64_t)nprocs) >> 32);
+}
+
+// Reserva espacio para `capacity` entradas. Devuelve 0 si no hay memoria.
+static inline int des_mitm_table_init(des_mitm_table_t *t, long capacity) {
+    uint64_t size = 16;
+    while (size < 2 * (uint64_t)capacity) size <<= 1;
+    t->value = malloc(size * sizeof(uint64_t));
+    t->key = malloc(size * sizeof(long));
+    t->mask = size - 1;
+    t->limit = (long)(size / 4 * 3);
+    if (!t->value || !t->key) {
+        free(t->value);
+        free(t->key);
+        t->value = NULL;
+        t->key = NULL;
+        return 0;
+    }
+    memset(t->key, 0xFF, size * sizeof(long));
+    t->count = 0;
+    return 1;
+}
+
+static inline void des_mitm_table_clear(des_mitm_table_t *t) {
+    memset(t->key, 0xFF, (t->mask + 1) * sizeof(long));
+    t->count = 0;
+}
+
+// Devuelve 0 si la tabla local está llena (reparto muy desigual o -M demasiado pequeño)
+static inline int des_mitm_table_add(des_mitm_table_t *t, uint64_t v, long key) {
+    if (t->count >= t->limit) return 0;
+    uint64_t h = des_block_hash(v) & t->mask;
+    while (t->key[h] >= 0) h = (h + 1) & t->mask;
+    t->value[h] = v;
+    t->key[h] = key;
+    t->count++;
+    return 1;
+}
+
+// Recorre las entradas con valor v, igual que des_blocktab_find
+static inline long des_mitm_table_find(const des_mitm_table_t *t, uint64_t v, long slot) {
+    uint64_t h = (slot < 0) ? (des_block_hash(v) & t->mask) : (((uint64_t)slot + 1) & t->mask);
+    while (t->key[h] >= 0) {
+        if (t->value[h] == v) return (long)h;
+        h = (h + 1) & t->mask;
+    }
+    return -1;
+}
+
+static inline void des_mitm_table_free(des_mitm_table_t *t) {
+    free(t->value);
+    free(t->key);
+    t->value = NULL;
+    t->key = NULL;
+}
+
+// Buffers del intercambio por lotes. Los contadores van en bytes (MPI_BYTE).
+typedef struct {
+    des_mitm_pair *send, *recv;
+    long send_cap, recv_cap;       // en pares
+    int *scount, *sdispl, *rcount, *rdispl;
+    int nprocs;
+} des_mitm_exchange_t;
+
+static inline int des_mitm_exchange_init(des_mitm_exchange_t *x, int nprocs, long batch) {
+    x->nprocs = nprocs;
+    x->send_cap = batch;
+    x->recv_cap = batch;
+    x->send = malloc(batch * sizeof(des_mitm_pair));
+    x->recv = malloc(batch * sizeof(des_mitm_pair));
+    x->scount = calloc(4 * nprocs, sizeof(int));
+    x->sdispl = x->scount + nprocs;
+    x->rcount = x->scount + 2 * nprocs;
+    x->rdispl = x->scount + 3 * nprocs;
+    return x->send && x->recv && x->scount;
+}
+
+// Agrupa los n pares por dueño (n <= batch) y los entrega con Alltoallv. Es colectiva: todos
+// los procesos la llaman el mismo número de veces, aunque no tengan pares. Devuelve cuántos
+// pares recibió este proceso (en x->recv), o -1 si no hay memoria.
+static inline long des_mitm_exchange(des_mitm_exchange_t *x, const des_mitm_pair *pairs, long n,
+                                     MPI_Comm comm) {
+    int P = x->nprocs;
+    long total = 0;
+
+    memset(x->scount, 0, P * sizeof(int));
+    for (long i = 0; i < n; i++) x->scount[des_mitm_owner(pairs[i].value, P)]++;
+    for (int p = 0, at = 0; p < P; p++) {
+        x->sdispl[p] = at;
+        at += x->scount[p];
+    }
+    for (long i = 0; i < n; i++) {
+        int p = des_mitm_owner(pairs[i].value, P);
+        x->send[x->sdispl[p]++] = pairs[i];
+    }
+    for (int p = 0; p < P; p++) {
+        x->sdispl[p] -= x->scount[p];
+        x->sdispl[p] *= sizeof(des_mitm_pair);
+        x->scount[p] *= sizeof(des_mitm_pair);
+    }
+
+    MPI_Alltoall(x->scount, 1, MPI_INT, x->rcount, 1, MPI_INT, comm);
+    for (int p = 0; p < P; p++) {
+        x->rdispl[p] = (int)(total * sizeof(des_mitm_pair));
+        total += x->rcount[p] / sizeof(des_mitm_pair);
+    }
+    if (total > x->recv_cap) {
+        des_mitm_pair *grown = realloc(x->recv, total * sizeof(des_mitm_pair));
+        if (!grown) return -1;
+        x->recv = grown;
+        x->recv_cap = total;
+    }
+
+    MPI_Alltoallv(x->send, x->scount, x->sdispl, MPI_BYTE,
+                  x->recv, x->rcount, x->rdispl, MPI_BYTE, comm);
+    return total;
+}
+
+static inline void des_mitm_exchange_free(des_mitm_exchange_t *x) {
+    free(x->send);
+    free(x->recv);
+    free(x->scount);
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef DES_POLL_H
+#define DES_POLL_H
+
+// Cada cuánto se revisan los avisos (parada, objetivos) y el tiempo límite. Antes era un
+// número fijo de claves por proceso, que con un kernel 10-100 veces más rápido dejaba pasar
+// muy poco tiempo entre revisiones, o demasiado con uno más lento. Ahora la revisión vence por
+// tiempo: en el bucle caliente solo se lee el contador de ciclos y se compara con el próximo
+// vencimiento (des_poll_due), y cada revisión (des_poll_begin) programa la siguiente a
+// `latency` segundos. Los ciclos por segundo se miden al empezar y se corrigen en cada
+// revisión con MPI_Wtime, que ya no se llama por lote.
+
+#include <stdint.h>
+#include <time.h>
+#include <mpi.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define DES_POLL_LATENCY 0.005    // tiempo máximo entre revisiones (parada vista en ~5 ms)
+#define DES_POLL_CALIBRATE 0.001  // duración de la medición inicial de ciclos por segundo
+
+typedef struct {
+    double latency;     // segundos entre revisiones
+    double cps;         // ciclos por segundo estimados
+    uint64_t next;      // ciclo en el que vence la próxima revisión
+    uint64_t last_tick;
+    double last_time;
+    double now;         // MPI_Wtime() de la última revisión
+    double start;
+    double deadline;    // 0 = sin tiempo límite
+    unsigned long polls;
+} des_poll_t;
+
+// Contador barato y monótono: TSC en x86, nanosegundos en el resto
+static inline uint64_t des_poll_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void des_poll_schedule(des_poll_t *p) {
+    p->next = p->last_tick + (uint64_t)(p->latency * p->cps);
+}
+
+// timeout <= 0: sin tiempo límite. start es el instante que cuenta para el tiempo límite.
+static inline void des_poll_init(des_poll_t *p, double latency, double timeout, double start) {
+    double t0 = MPI_Wtime(), t1;
+    uint64_t c0 = des_poll_ticks(), c1;
+
+    do {
+        t1 = MPI_Wtime();
+        c1 = des_poll_ticks();
+    } while (t1 - t0 < DES_POLL_CALIBRATE);
+
+    p->latency = latency > 0 ? latency : DES_POLL_LATENCY;
+    p->cps = (c1 > c0) ? (c1 - c0) / (t1 - t0) : 1e9;
+    p->last_tick = c1;
+    p->last_time = t1;
+    p->now = t1;
+    p->start = start;
+    p->deadline = timeout > 0 ? start + timeout : 0.0;
+    p->polls = 0;
+    des_poll_schedule(p);
+}
+
+// En el bucle caliente, tras cada lote: 1 si toca revisar
+static inline int des_poll_due(const des_poll_t *p) {
+    return des_poll_ticks() >= p->next;
+}
+
+// Empieza una revisión: corrige los ciclos por segundo, programa la siguiente y devuelve 1 si
+// ya pasó el tiempo límite. p->now queda con la hora actual.
+static inline int des_poll_begin(des_poll_t *p) {
+    uint64_t tick = des_poll_ticks();
+    double now = MPI_Wtime();
+
+    if (now > p->last_time && tick > p->last_tick) {
+        double measured = (tick - p->last_tick) / (now - p->last_time);
+        p->cps = 0.75 * p->cps + 0.25 * measured;
+    }
+    p->last_tick = tick;
+    p->last_time = now;
+    p->now = now;
+    p->polls++;
+    des_poll_schedule(p);
+    return p->deadline > 0 && now >= p->deadline;
+}
+
+#endif
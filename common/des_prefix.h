@@ -0,0 +1,58 @@
+#ifndef DES_PREFIX_H
+#define DES_PREFIX_H
+
+// Texto conocido (-p): inicio exacto del mensaje en claro. Con él cada clave cuesta un solo
+// bloque DES y una comparación de 64 bits (des_bs_match); el descifrado completo y strstr
+// solo se hacen para las claves que coinciden.
+//
+// El argumento es texto ("Esta es") o hexadecimal con prefijo 0x ("0x45737461").
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define DES_PREFIX_MAX 256
+
+typedef struct {
+    unsigned char text[DES_PREFIX_MAX];   // prefijo completo (se verifica tras un acierto)
+    int len;                              // 0 = modo desactivado
+    unsigned char block[8];               // primer bloque esperado
+    unsigned char care[8];                // bytes conocidos del primer bloque
+} des_prefix_t;
+
+// Devuelve 0 si el argumento no es válido
+static inline int des_prefix_parse(des_prefix_t *p, const char *arg) {
+    memset(p, 0, sizeof(*p));
+
+    if (arg[0] == '0' && (arg[1] == 'x' || arg[1] == 'X')) {
+        const char *hex = arg + 2;
+        int n = strlen(hex);
+        if (n == 0 || n % 2 != 0 || n / 2 > DES_PREFIX_MAX) return 0;
+        for (int i = 0; i < n; i++) {
+            if (!isxdigit((unsigned char)hex[i])) return 0;
+        }
+        for (int i = 0; i < n / 2; i++) {
+            char byte[3] = { hex[2 * i], hex[2 * i + 1], 0 };
+            p->text[i] = (unsigned char)strtoul(byte, NULL, 16);
+        }
+        p->len = n / 2;
+    } else {
+        int n = strlen(arg);
+        if (n == 0 || n > DES_PREFIX_MAX) return 0;
+        memcpy(p->text, arg, n);
+        p->len = n;
+    }
+
+    for (int i = 0; i < 8 && i < p->len; i++) {
+        p->block[i] = p->text[i];
+        p->care[i] = 0xFF;
+    }
+    return 1;
+}
+
+// Comprueba el prefijo completo sobre un texto ya descifrado
+static inline int des_prefix_check(const des_prefix_t *p, const unsigned char *plain, int len) {
+    return p->len <= len && memcmp(plain, p->text, p->len) == 0;
+}
+
+#endif
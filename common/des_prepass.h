@@ -0,0 +1,160 @@
+#ifndef DES_PREPASS_H
+#define DES_PREPASS_H
+
+// Pasada previa (--prepass) por las claves que suele elegir una persona, antes del barrido
+// uniforme. Cada familia es una lista numerada (des_prepass_key convierte el número en la
+// clave), las familias elegidas se concatenan y cada proceso recorre su tramo.
+//
+//   p  pocos bits en 1: peso de Hamming 0..3 sobre los 56 bits (2^51, 2^55 + 2^53, ...)
+//   s  valores pequeños: [0, 2^24)
+//   r  bytes repetidos: los 8 bytes iguales o alternando dos valores
+//   a  texto: 1 a 6 caracteres [0-9a-z] seguidos de ceros, como al copiar una contraseña
+//      al bloque de clave
+//   d  fechas 1900-2099: "AAAAMMDD" y "DDMMAAAA" en texto, y AAAAMMDD como número
+//
+// Las familias pueden solaparse (una clave pequeña con pocos bits en 1 está en p y en s):
+// esas claves se prueban dos veces, lo que no cambia el costo total de forma apreciable.
+
+#include <stdio.h>
+#include <string.h>
+#include "des_keys.h"
+#include "des_hamming.h"
+
+#define DES_PREPASS_ALL "psrad"
+#define DES_PREPASS_POPCOUNT 3
+#define DES_PREPASS_SMALL_BITS 24
+#define DES_PREPASS_TEXT_LEN 6
+#define DES_PREPASS_DATES (200 * 12 * 31)
+
+typedef struct {
+    char families[8];
+    int n;
+    unsigned long size[8];
+    unsigned long total;
+    unsigned char text_value[64];   // valores de 7 bits distintos de [0-9a-z]
+    int text_n;
+} des_prepass_t;
+
+static inline unsigned long des_prepass_size(const des_prepass_t *p, char family) {
+    unsigned long size = 0, power = 1;
+
+    switch (family) {
+    case 'p':
+        for (int d = 0; d <= DES_PREPASS_POPCOUNT; d++) size += des_hamming_count(d);
+        return size;
+    case 's': return 1UL << DES_PREPASS_SMALL_BITS;
+    case 'r': return 128 + 128 * 128;
+    case 'a':
+        for (int len = 1; len <= DES_PREPASS_TEXT_LEN; len++) size += (power *= p->text_n);
+        return size;
+    case 'd': return 3 * DES_PREPASS_DATES;
+    }
+    return 0;
+}
+
+// Devuelve 0 si alguna letra no es una familia
+static inline int des_prepass_init(des_prepass_t *p, const char *families) {
+    const char *chars = "0123456789abcdefghijklmnopqrstuvwxyz";
+    int seen[128] = {0};
+
+    memset(p, 0, sizeof(*p));
+    des_hamming_init();
+    for (const char *c = chars; *c; c++) {
+        if (!seen[*c >> 1]) {
+            seen[*c >> 1] = 1;
+            p->text_value[p->text_n++] = (unsigned char)(*c >> 1);
+        }
+    }
+    for (const char *f = families; *f; f++) {
+        if (!strchr(DES_PREPASS_ALL, *f) || p->n == 8) return 0;
+        if (memchr(p->families, *f, p->n)) continue;
+        p->families[p->n] = *f;
+        p->size[p->n] = des_prepass_size(p, *f);
+        p->total += p->size[p->n];
+        p->n++;
+    }
+    return p->n > 0;
+}
+
+// Índice canónico de 8 caracteres (el bit de paridad de cada byte no cuenta)
+static inline long des_prepass_text(const char *text) {
+    DES_cblock block;
+    memcpy(block, text, 8);
+    return des_key_from_block(&block);
+}
+
+// Clave número i de la familia
+static inline long des_prepass_family_key(const des_prepass_t *p, char family, unsigned long i) {
+    long key = 0;
+    char text[9];
+
+    switch (family) {
+    case 'p': {
+        int d = 0;
+        while (i >= des_hamming_count(d)) i -= des_hamming_count(d++);
+        return (long)des_hamming_unrank(d, i);
+    }
+    case 's':
+        return (long)i;
+    case 'r': {
+        long v0 = i < 128 ? (long)i : (long)((i - 128) & 127);
+        long v1 = i < 128 ? (long)i : (long)((i - 128) >> 7);
+        for (int b = 0; b < 8; b++) key |= ((b & 1) ? v1 : v0) << (7 * b);
+        return key;
+    }
+    case 'a': {
+        unsigned long power = p->text_n;
+        int len = 1;
+        while (i >= power) {
+            i -= power;
+            power *= p->text_n;
+            len++;
+        }
+        for (int b = 0; b < len; b++) {
+            key |= (long)p->text_value[i % p->text_n] << (7 * b);
+            i /= p->text_n;
+        }
+        return key;
+    }
+    case 'd': {
+        unsigned long form = i / DES_PREPASS_DATES, day = i % DES_PREPASS_DATES;
+        int y = 1900 + (int)(day / (12 * 31)), m = 1 + (int)(day / 31 % 12), dd = 1 + (int)(day % 31);
+        if (form == 2) return (long)y * 10000 + m * 100 + dd;
+        if (form == 0) snprintf(text, sizeof(text), "%04d%02d%02d", y, m, dd);
+        else snprintf(text, sizeof(text), "%02d%02d%04d", dd, m, y);
+        return des_prepass_text(text);
+    }
+    }
+    return 0;
+}
+
+// Clave número i de la pasada (0 <= i < p->total)
+static inline long des_prepass_key(const des_prepass_t *p, unsigned long i) {
+    int f = 0;
+    while (i >= p->size[f]) i -= p->size[f++];
+    return des_prepass_family_key(p, p->families[f], i);
+}
+
+// Rango contiguo de claves ya cubierto por la pasada (la familia s), para que el barrido lo
+// salte. Devuelve 0 si no hay.
+static inline int des_prepass_range(const des_prepass_t *p, long *lo, long *hi) {
+    if (!memchr(p->families, 's', p->n)) return 0;
+    *lo = 0;
+    *hi = 1L << DES_PREPASS_SMALL_BITS;
+    return 1;
+}
+
+// Descripción de las familias con su tamaño
+static inline void des_prepass_describe(const des_prepass_t *p, char *out, size_t size) {
+    static const char *names[] = { "pocos bits en 1", "valores pequeños", "bytes repetidos",
+                                   "texto", "fechas" };
+    int n = 0;
+
+    out[0] = '\0';
+    for (int f = 0; f < p->n && (size_t)n < size; f++) {
+        const char *name = names[strchr(DES_PREPASS_ALL, p->families[f]) - DES_PREPASS_ALL];
+        n += snprintf(out + n, size - n, "%s%s (%lu)", f ? ", " : "", name, p->size[f]);
+    }
+}
+
+#endif
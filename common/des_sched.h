@@ -0,0 +1,214 @@
+#ifndef DES_SCHED_H
+#define DES_SCHED_H
+
+// Reparto dinámico del rango de claves (coordinador/trabajadores). El proceso 0 corta
+// trozos consecutivos de [lo, hi) y los entrega a petición, además de buscar en los suyos:
+// entre lote y lote atiende las peticiones pendientes (des_sched_serve). Cada trabajador pide
+// el trozo siguiente en cuanto empieza el actual (Isend + Irecv), así que al terminarlo ya lo
+// tiene y no espera al coordinador. El tamaño de cada trozo es lo que ese proceso recorre en
+// DES_SCHED_SECONDS según la velocidad que midió en su trozo anterior.
+//
+// Como las claves se reparten de menor a mayor, todos los procesos trabajan cerca del
+// principio del rango: una clave baja ya no le toca entera a un solo proceso, y un nodo lento
+// solo retrasa el trozo que tiene en curso.
+//
+// Con s->ckpt (solo en el proceso 0) el coordinador salta los intervalos ya recorridos y
+// anota cada trozo terminado: el suyo al pedir el siguiente, el de un trabajador cuando llega
+// su petición (que lleva el trozo que acaba de terminar) o su informe final al cerrar. Un
+// trozo interrumpido (clave encontrada o tiempo agotado) no se anota y se repite al reanudar.
+
+#include <string.h>
+#include <mpi.h>
+#include "des_ckpt.h"
+
+#define DES_SCHED_REQ 2          // trabajador -> 0: {claves/s, tipo, trozo terminado}
+#define DES_SCHED_MORE 0         //   tipo: pide otro trozo
+#define DES_SCHED_DONE 1         //   tipo: terminó, espera "parar"
+#define DES_SCHED_REPORT 2       //   tipo: informe final, sin respuesta
+#define DES_SCHED_CHUNK 3        // 0 -> trabajador: {base, count}; count == 0 = parar
+#define DES_SCHED_SECONDS 0.25   // duración objetivo de un trozo
+#define DES_SCHED_MIN (1L << 16) // tamaño del primer trozo y mínimo
+#define DES_SCHED_MAX (1L << 36)
+
+typedef struct {
+    MPI_Comm comm;
+    int id, nprocs;
+    long align;             // los trozos son múltiplos de align (carriles del kernel)
+    double started;         // inicio del trozo actual
+    long base, current;     // trozo actual
+    unsigned long chunks;   // trozos recibidos por este proceso
+
+    // Proceso 0
+    long next, end;         // siguiente clave por repartir y fin del rango
+    int stopping;           // contestar "parar" a todas las peticiones
+    int stopped;            // trabajadores que ya recibieron "parar"
+    int reports;            // informes finales recibidos
+    long request[4];
+    des_ckpt_t *ckpt;       // intervalos recorridos (NULL = sin checkpoint)
+    MPI_Request req_in;
+
+    // Trabajadores
+    long ask[4], reply[2];
+    MPI_Request req_out, req_reply;
+    int pending;            // petición enviada sin respuesta todavía
+    int done;               // ya recibió "parar"
+    long last[2];           // último trozo recorrido entero y sin anotar todavía
+} des_sched_t;
+
+// Trozo del tamaño que corresponde a `rate` claves/s (0 = sin medir todavía)
+static inline long des_sched_size(const des_sched_t *s, long rate) {
+    long size = rate > 0 ? (long)(rate * DES_SCHED_SECONDS) : DES_SCHED_MIN;
+    if (size < DES_SCHED_MIN) size = DES_SCHED_MIN;
+    if (size > DES_SCHED_MAX) size = DES_SCHED_MAX;
+    return size / s->align * s->align;
+}
+
+// Corta el siguiente trozo del rango (solo el proceso 0). count = 0 si no quedan claves.
+static inline void des_sched_take(des_sched_t *s, long rate, long *base, long *count) {
+    long size = des_sched_size(s, rate);
+    long limit = s->end;
+
+    if (s->ckpt) s->next = des_ckpt_skip(s->ckpt, s->next, &limit);
+    if (limit > s->end) limit = s->end;
+    if (s->stopping || s->next >= s->end) {
+        *base = s->end;
+        *count = 0;
+        return;
+    }
+    if (size > limit - s->next) size = limit - s->next;
+    *base = s->next;
+    *count = size;
+    s->next += size;
+}
+
+// done_count = 0: no terminó ningún trozo desde la última petición
+static inline void des_sched_ask(des_sched_t *s, long rate, int type, long done_base,
+                                 long done_count) {
+    s->ask[0] = rate;
+    s->ask[1] = type;
+    s->ask[2] = done_base;
+    s->ask[3] = done_count;
+    MPI_Irecv(s->reply, 2, MPI_LONG, 0, DES_SCHED_CHUNK, s->comm, &s->req_reply);
+    MPI_Isend(s->ask, 4, MPI_LONG, 0, DES_SCHED_REQ, s->comm, &s->req_out);
+    s->pending = 1;
+}
+
+// El proceso 0 espera peticiones hasta que todos recibieron "parar" y enviaron su informe
+static inline int des_sched_listening(const des_sched_t *s) {
+    return s->stopped < s->nprocs - 1 || s->reports < s->nprocs - 1;
+}
+
+// Contesta la petición recibida en s->request y vuelve a escuchar si quedan trabajadores
+static inline void des_sched_reply(des_sched_t *s, int worker) {
+    long chunk[2] = { s->end, 0 };
+
+    if (s->ckpt) des_ckpt_add(s->ckpt, s->request[2], s->request[2] + s->request[3]);
+    if (s->request[1] == DES_SCHED_REPORT) {
+        s->reports++;
+    } else {
+        if (s->request[1] == DES_SCHED_MORE) des_sched_take(s, s->request[0], &chunk[0], &chunk[1]);
+        if (chunk[1] == 0) s->stopped++;
+        // El trabajador ya tiene el Irecv puesto
+        MPI_Send(chunk, 2, MPI_LONG, worker, DES_SCHED_CHUNK, s->comm);
+    }
+    if (des_sched_listening(s)) {
+        MPI_Irecv(s->request, 4, MPI_LONG, MPI_ANY_SOURCE, DES_SCHED_REQ, s->comm, &s->req_in);
+    }
+}
+
+// El proceso 0 reparte [lo, hi); los demás piden ya su primer trozo
+static inline void des_sched_init(des_sched_t *s, long lo, long hi, int align, MPI_Comm comm) {
+    memset(s, 0, sizeof(*s));
+    s->comm = comm;
+    MPI_Comm_rank(comm, &s->id);
+    MPI_Comm_size(comm, &s->nprocs);
+    s->align = align;
+    s->next = lo;
+    s->end = hi;
+
+    if (s->nprocs == 1) return;
+    if (s->id == 0) {
+        MPI_Irecv(s->request, 4, MPI_LONG, MPI_ANY_SOURCE, DES_SCHED_REQ, comm, &s->req_in);
+    } else {
+        des_sched_ask(s, 0, DES_SCHED_MORE, 0, 0);
+    }
+}
+
+// Atiende las peticiones que ya llegaron (solo hace algo en el proceso 0). Se llama entre
+// lotes: cuesta un MPI_Test si no hay nada.
+static inline void des_sched_serve(des_sched_t *s) {
+    MPI_Status st;
+    int flag;
+
+    if (s->id != 0) return;
+    while (des_sched_listening(s)) {
+        MPI_Test(&s->req_in, &flag, &st);
+        if (!flag) return;
+        des_sched_reply(s, st.MPI_SOURCE);
+    }
+}
+
+// Siguiente trozo [base, base + count) para este proceso. Devuelve 0 cuando ya no hay más.
+static inline int des_sched_next(des_sched_t *s, long *base, long *count) {
+    double now = MPI_Wtime();
+    long rate = (s->current > 0 && now > s->started) ? (long)(s->current / (now - s->started)) : 0;
+
+    if (s->id == 0) {
+        if (s->ckpt) des_ckpt_add(s->ckpt, s->base, s->base + s->current);
+        des_sched_serve(s);
+        des_sched_take(s, rate, base, count);
+    } else {
+        if (s->done) return 0;
+        MPI_Wait(&s->req_reply, MPI_STATUS_IGNORE);
+        MPI_Wait(&s->req_out, MPI_STATUS_IGNORE);
+        s->pending = 0;
+        *base = s->reply[0];
+        *count = s->reply[1];
+        if (*count == 0) {
+            s->done = 1;
+            s->last[0] = s->base;   // va en el informe final
+            s->last[1] = s->current;
+            return 0;
+        }
+        // El siguiente llega mientras se recorre este; la petición anota el anterior
+        des_sched_ask(s, rate, DES_SCHED_MORE, s->base, s->current);
+    }
+    if (*count == 0) return 0;
+    s->started = now;
+    s->base = *base;
+    s->current = *count;
+    s->chunks++;
+    return 1;
+}
+
+// Cierre colectivo tras el bucle de búsqueda. Cada trabajador espera la respuesta de su
+// petición pendiente (un trozo que llegue tarde se descarta), avisa de que terminó y envía
+// su informe final; el proceso 0 contesta "parar" hasta que todos lo recibieron y espera los
+// informes.
+static inline void des_sched_finish(des_sched_t *s) {
+    MPI_Status st;
+
+    if (s->nprocs == 1) return;
+    if (s->id == 0) {
+        s->stopping = 1;
+        while (des_sched_listening(s)) {
+            MPI_Wait(&s->req_in, &st);
+            des_sched_reply(s, st.MPI_SOURCE);
+        }
+        return;
+    }
+    while (!s->done) {
+        if (!s->pending) des_sched_ask(s, 0, DES_SCHED_DONE, 0, 0);
+        MPI_Wait(&s->req_reply, MPI_STATUS_IGNORE);
+        MPI_Wait(&s->req_out, MPI_STATUS_IGNORE);
+        s->pending = 0;
+        if (s->reply[1] == 0) s->done = 1;
+    }
+    s->ask[0] = 0;
+    s->ask[1] = DES_SCHED_REPORT;
+    s->ask[2] = s->last[0];
+    s->ask[3] = s->last[1];
+    MPI_Send(s->ask, 4, MPI_LONG, 0, DES_SCHED_REQ, s->comm);
+}
+
+#endif
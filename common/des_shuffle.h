@@ -0,0 +1,133 @@
+#ifndef DES_SHUFFLE_H
+#define DES_SHUFFLE_H
+
+// Recorrido del espacio de claves en orden pseudoaleatorio (--shuffle). El reparto
+// (des_sched.h) sigue cortando trozos consecutivos, pero de un espacio "virtual" dividido en
+// bloques de 2^DES_SHUFFLE_BLOCK_BITS claves: el bloque virtual v se recorre en el bloque real
+// des_shuffle_block(v), una permutación con clave (red de Feistel sobre los bits del índice
+// de bloque, con cycle-walking si el número de bloques no es potencia de 4). Dentro de cada
+// bloque las claves siguen siendo contiguas, así que el kernel bitsliced y el orden Gray
+// conservan su localidad, y cualquier prefijo del trabajo es una muestra uniforme del espacio:
+// el tiempo esperado hasta dar con la clave ya no depende de dónde cae.
+
+#include <stdint.h>
+#include "des_gray.h"
+
+#define DES_SHUFFLE_BLOCK_BITS 16   // 2^16 claves por bloque (1024 lotes de 64)
+#define DES_SHUFFLE_ROUNDS 6
+
+typedef struct {
+    uint64_t seed;        // 0 = sin permutación
+    int half;             // bits de cada mitad de la red
+    uint64_t nblocks;     // bloques reales (el último puede estar incompleto)
+    long limit;           // fin del rango real
+    uint64_t round_key[DES_SHUFFLE_ROUNDS];
+} des_shuffle_t;
+
+static inline uint64_t des_shuffle_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Permutación de [0, limit) por bloques. seed = 0 deja el orden natural.
+static inline void des_shuffle_init(des_shuffle_t *s, long limit, uint64_t seed) {
+    uint64_t block = 1ULL << DES_SHUFFLE_BLOCK_BITS;
+    int bits = 0;
+
+    s->seed = seed;
+    s->limit = limit;
+    s->nblocks = ((uint64_t)limit + block - 1) / block;
+    while ((1ULL << bits) < s->nblocks) bits++;
+    s->half = (bits + 1) / 2;
+    for (int r = 0; r < DES_SHUFFLE_ROUNDS; r++) {
+        s->round_key[r] = des_shuffle_mix(seed + (uint64_t)r * 0xD1B54A32D192ED03ULL);
+    }
+}
+
+// Fin del espacio virtual que debe repartir des_sched
+static inline long des_shuffle_end(const des_shuffle_t *s) {
+    return s->seed ? (long)(s->nblocks << DES_SHUFFLE_BLOCK_BITS) : s->limit;
+}
+
+// Bloque real que corresponde al bloque virtual v (v < nblocks)
+static inline uint64_t des_shuffle_block(const des_shuffle_t *s, uint64_t v) {
+    uint64_t mask = (1ULL << s->half) - 1;
+
+    do {
+        uint64_t left = v >> s->half, right = v & mask;
+        for (int r = 0; r < DES_SHUFFLE_ROUNDS; r++) {
+            uint64_t next = left ^ (des_shuffle_mix(right ^ s->round_key[r]) & mask);
+            left = right;
+            right = next;
+        }
+        v = (left << s->half) | right;
+    } while (v >= s->nblocks);   // cycle-walking: el dominio de la red es hasta 4x mayor
+    return v;
+}
+
+// Siguiente tramo real contiguo del trozo virtual [*cursor, end). Avanza *cursor y devuelve
+// 0 cuando el trozo está completo. Sin permutación el tramo es el trozo entero.
+static inline int des_shuffle_next(const des_shuffle_t *s, long *cursor, long end, long *base,
+                                   long *count) {
+    while (*cursor < end) {
+        long v = *cursor;
+
+        if (!s->seed) {
+            *base = v;
+            *count = end - v;
+            *cursor = end;
+            return 1;
+        }
+
+        long block = 1L << DES_SHUFFLE_BLOCK_BITS;
+        long offset = v & (block - 1);
+        long stop = (v | (block - 1)) + 1;
+        if (stop > end) stop = end;
+        *cursor = stop;
+
+        long real = (long)(des_shuffle_block(s, (uint64_t)v >> DES_SHUFFLE_BLOCK_BITS)
+                           << DES_SHUFFLE_BLOCK_BITS) + offset;
+        long real_end = real + (stop - v);
+        if (real_end > s->limit) real_end = s->limit;   // último bloque incompleto
+        if (real < real_end) {
+            *base = real;
+            *count = real_end - real;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Recorrido por lotes Gray de un trozo virtual: une des_shuffle_next y des_gray_next para que
+// el bucle de búsqueda siga teniendo un solo nivel por trozo
+typedef struct {
+    const des_shuffle_t *s;
+    des_gray_t gray;
+    long cursor, end;
+    int lanes;
+    int active;
+} des_shuffle_walk_t;
+
+static inline void des_shuffle_walk_init(des_shuffle_walk_t *w, const des_shuffle_t *s, long lo,
+                                         long hi, int lanes) {
+    w->s = s;
+    w->cursor = lo;
+    w->end = hi;
+    w->lanes = lanes;
+    w->active = 0;
+}
+
+static inline int des_shuffle_walk_next(des_shuffle_walk_t *w, long *key, int *count) {
+    long base, size;
+
+    while (1) {
+        if (w->active && des_gray_next(&w->gray, key, count)) return 1;
+        if (!des_shuffle_next(w->s, &w->cursor, w->end, &base, &size)) return 0;
+        des_gray_init(&w->gray, base, base + size, w->lanes);
+        w->active = 1;
+    }
+}
+
+#endif
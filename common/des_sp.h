@@ -0,0 +1,197 @@
+#ifndef DES_SP_H
+#define DES_SP_H
+
+// DES escalar con tablas, para el camino de búsqueda que no va por el kernel bitsliced
+// (verificación de candidatos y programas secuenciales). OpenSSL sigue siendo la
+// referencia de -e/-d.
+//
+//   - S-box y permutación P combinadas: des_sp[i][x] es la salida de la S-box i para la
+//     entrada de 6 bits x, ya permutada por P. Una ronda son 8 consultas y XOR.
+//   - Se trabaja en el dominio permutado: un bloque pasa por IP una sola vez al cargarlo
+//     (des_sp_ip) y un resultado solo pasa por FP si hay que mirar sus bytes; para comparar
+//     con un bloque conocido basta aplicarle IP a este una vez.
+//   - Subclaves a partir del índice canónico con una tabla por cada grupo de 7 bits: 8 XOR
+//     por ronda, y solo 1 si cambian únicamente los 7 bits bajos (des_sp_key_low).
+//   - des_sp_crypt procesa hasta 4 claves intercaladas; las rondas de claves distintas son
+//     independientes y se solapan en el procesador.
+//
+// Estado: uint64_t con L en los 32 bits altos y R en los bajos (bit 63 = bit DES 1).
+
+#include <stdint.h>
+#include <string.h>
+#include <openssl/des.h>
+#include "des_tables.h"
+#include "des_keys.h"
+
+#define DES_SP_WAYS 4   // claves intercaladas como máximo en des_sp_crypt
+
+// Subclaves: k[r] lleva los 8 grupos de 6 bits colocados donde los lee la ronda (los pares
+// en los 32 bits bajos, los impares en los altos)
+typedef struct {
+    uint64_t k[16];
+} des_sp_key;
+
+static uint32_t des_sp[8][64];
+static uint64_t des_sp_ip_tab[8][256];
+static uint64_t des_sp_fp_tab[8][256];
+static uint64_t des_sp_key_tab[8][128][16];   // grupo de 7 bits del índice -> subclaves
+static int des_sp_ready = 0;
+
+static inline uint32_t des_sp_rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static inline void des_sp_init(void) {
+    static const int offset[8] = { 0, 0, 24, 24, 16, 16, 8, 8 };
+    unsigned char ks[16][48];
+
+    if (des_sp_ready) return;
+
+    for (int i = 0; i < 8; i++) {
+        for (int x = 0; x < 64; x++) {
+            int row = ((x >> 4) & 2) | (x & 1), col = (x >> 1) & 15;
+            uint32_t s = (uint32_t)des_sbox[i][row][col] << (28 - 4 * i), out = 0;
+            for (int j = 0; j < 32; j++) {
+                if ((s >> (32 - des_p[j])) & 1) out |= 1u << (31 - j);
+            }
+            des_sp[i][x] = out;
+        }
+    }
+
+    // IP: el bit o de la salida es el bit des_ip[o] de la entrada; FP es la inversa
+    memset(des_sp_ip_tab, 0, sizeof(des_sp_ip_tab));
+    memset(des_sp_fp_tab, 0, sizeof(des_sp_fp_tab));
+    for (int o = 0; o < 64; o++) {
+        int n = des_ip[o] - 1;
+        for (int v = 0; v < 256; v++) {
+            if ((v >> (7 - n % 8)) & 1) des_sp_ip_tab[n / 8][v] |= 1ULL << (63 - o);
+            if ((v >> (7 - o % 8)) & 1) des_sp_fp_tab[o / 8][v] |= 1ULL << (63 - n);
+        }
+    }
+
+    // Bit DES b de la clave (byte b/8, bit 7 - b%8) = bit 7*(b/8) + 6 - b%8 del índice
+    des_key_schedule_bits(ks);
+    memset(des_sp_key_tab, 0, sizeof(des_sp_key_tab));
+    for (int r = 0; r < 16; r++) {
+        for (int j = 0; j < 48; j++) {
+            int b = ks[r][j];
+            int q = 7 * (b / 8) + 6 - b % 8;
+            int chunk = j / 6;
+            uint64_t bit = 1ULL << ((chunk & 1) * 32 + offset[chunk] + 5 - j % 6);
+            for (int v = 0; v < 128; v++) {
+                if ((v >> (q % 7)) & 1) des_sp_key_tab[q / 7][v][r] |= bit;
+            }
+        }
+    }
+    des_sp_ready = 1;
+}
+
+// Subclaves del índice canónico key
+static inline void des_sp_set_key(des_sp_key *ks, long key) {
+    for (int r = 0; r < 16; r++) {
+        uint64_t k = 0;
+        for (int c = 0; c < 8; c++) k ^= des_sp_key_tab[c][(key >> (7 * c)) & 127][r];
+        ks->k[r] = k;
+    }
+}
+
+// Subclaves de (high con los 7 bits bajos a 0) | low, a partir de las de high
+static inline void des_sp_key_low(des_sp_key *ks, const des_sp_key *high, int low) {
+    for (int r = 0; r < 16; r++) ks->k[r] = high->k[r] ^ des_sp_key_tab[0][low][r];
+}
+
+// Bloque de 8 bytes -> IP(bloque)
+static inline uint64_t des_sp_ip(const unsigned char *in) {
+    uint64_t x = 0;
+    for (int b = 0; b < 8; b++) x |= des_sp_ip_tab[b][in[b]];
+    return x;
+}
+
+// FP(estado) -> bloque de 8 bytes
+static inline void des_sp_fp(uint64_t x, unsigned char *out) {
+    uint64_t y = 0;
+    for (int b = 0; b < 8; b++) y |= des_sp_fp_tab[b][(x >> (56 - 8 * b)) & 255];
+    for (int b = 0; b < 8; b++) out[b] = (unsigned char)(y >> (56 - 8 * b));
+}
+
+// 16 rondas sobre n <= DES_SP_WAYS estados (ya pasados por IP), cada uno con su clave.
+// El resultado queda en el dominio de IP: FP(state) es el bloque cifrado/descifrado.
+static inline void des_sp_crypt(const des_sp_key *const *ks, int n, uint64_t *state, int decrypt) {
+    uint32_t L[DES_SP_WAYS], R[DES_SP_WAYS];
+
+    for (int j = 0; j < n; j++) {
+        L[j] = (uint32_t)(state[j] >> 32);
+        R[j] = (uint32_t)state[j];
+    }
+    for (int r = 0; r < 16; r++) {
+        int kr = decrypt ? 15 - r : r;
+        for (int j = 0; j < n; j++) {
+            uint64_t k = ks[j]->k[kr];
+            uint32_t u = des_sp_rotl(R[j], 5) ^ (uint32_t)k;
+            uint32_t v = des_sp_rotl(R[j], 9) ^ (uint32_t)(k >> 32);
+            uint32_t f = des_sp[0][u & 63] ^ des_sp[2][(u >> 24) & 63] ^
+                         des_sp[4][(u >> 16) & 63] ^ des_sp[6][(u >> 8) & 63] ^
+                         des_sp[1][v & 63] ^ des_sp[3][(v >> 24) & 63] ^
+                         des_sp[5][(v >> 16) & 63] ^ des_sp[7][(v >> 8) & 63];
+            uint32_t t = L[j] ^ f;
+            L[j] = R[j];
+            R[j] = t;
+        }
+    }
+    // Sin el intercambio de la última ronda
+    for (int j = 0; j < n; j++) state[j] = ((uint64_t)R[j] << 32) | L[j];
+}
+
+// Un bloque completo (IP, rondas y FP); in y out pueden coincidir
+static inline void des_sp_block(const des_sp_key *ks, const unsigned char *in, unsigned char *out,
+                                int decrypt) {
+    uint64_t x = des_sp_ip(in);
+    des_sp_crypt(&ks, 1, &x, decrypt);
+    des_sp_fp(x, out);
+}
+
+// Compara con OpenSSL (cifrado, descifrado y claves intercaladas)
+static inline int des_sp_selftest(void) {
+    unsigned char in[8] = { 0x45, 0x73, 0x74, 0x61, 0x20, 0x65, 0x73, 0x20 };
+    long keys[DES_SP_WAYS] = { 123456L, 0L, (1L << 56) - 1, 0x0123456789ABCDL };
+    des_sp_key ks[DES_SP_WAYS];
+    const des_sp_key *kp[DES_SP_WAYS];
+    uint64_t state[DES_SP_WAYS];
+
+    des_sp_init();
+    for (int j = 0; j < DES_SP_WAYS; j++) {
+        DES_cblock keyblock;
+        DES_key_schedule schedule;
+        unsigned char ref[8], out[8];
+
+        des_key_to_block(keys[j], &keyblock);
+        DES_set_key_unchecked(&keyblock, &schedule);
+        des_sp_set_key(&ks[j], keys[j]);
+        kp[j] = &ks[j];
+        state[j] = des_sp_ip(in);
+
+        DES_ecb_encrypt((const_DES_cblock *)in, (DES_cblock *)ref, &schedule, DES_ENCRYPT);
+        des_sp_block(&ks[j], in, out, 0);
+        if (memcmp(ref, out, 8) != 0) return 0;
+        DES_ecb_encrypt((const_DES_cblock *)in, (DES_cblock *)ref, &schedule, DES_DECRYPT);
+        des_sp_block(&ks[j], in, out, 1);
+        if (memcmp(ref, out, 8) != 0) return 0;
+    }
+
+    des_sp_crypt(kp, DES_SP_WAYS, state, 1);
+    for (int j = 0; j < DES_SP_WAYS; j++) {
+        unsigned char out[8];
+        des_sp_key high, low;
+
+        des_sp_fp(state[j], out);
+        des_sp_block(&ks[j], out, out, 0);
+        if (memcmp(out, in, 8) != 0) return 0;
+
+        des_sp_set_key(&high, keys[j] & ~127L);
+        des_sp_key_low(&low, &high, (int)(keys[j] & 127));
+        if (memcmp(&low, &ks[j], sizeof(low)) != 0) return 0;
+    }
+    return 1;
+}
+
+#endif
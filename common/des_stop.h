@@ -0,0 +1,83 @@
+#ifndef DES_STOP_H
+#define DES_STOP_H
+
+// Señal global de parada con una ventana RMA (acceso pasivo). La bandera es un long en la
+// memoria del proceso 0. Quien encuentra la clave la publica con un solo MPI_Fetch_and_op
+// (MPI_MIN), así que el coste no depende del número de procesos y, si varios encuentran
+// claves, todos acaban con la menor. Los demás la leen con MPI_Fetch_and_op(MPI_NO_OP) cuando
+// les toca revisar. No hay mensajes que cancelar al terminar: la ventana se libera de forma
+// colectiva.
+//
+// Toda la época de acceso es una sola (MPI_Win_lock_all en des_stop_init), así que post y
+// check solo necesitan MPI_Win_flush.
+
+#include <limits.h>
+#include <mpi.h>
+
+#define DES_STOP_NONE (-1L)   // lo que devuelven check/finish mientras nadie encontró la clave
+#define DES_STOP_EMPTY LONG_MAX   // contenido de la bandera en ese caso (neutro para MPI_MIN)
+
+typedef struct {
+    MPI_Win win;
+    long *flag;   // memoria de la ventana (un long en el proceso 0, vacía en los demás)
+    long seen;    // último valor leído distinto de DES_STOP_NONE
+    MPI_Comm comm;
+} des_stop_t;
+
+// Colectiva
+static inline void des_stop_init(des_stop_t *s, MPI_Comm comm) {
+    int id;
+
+    MPI_Comm_rank(comm, &id);
+    s->comm = comm;
+    s->seen = DES_STOP_NONE;
+    MPI_Win_allocate(id == 0 ? sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, comm,
+                     &s->flag, &s->win);
+    if (id == 0) *s->flag = DES_STOP_EMPTY;
+    MPI_Barrier(comm);   // la bandera queda inicializada antes de cualquier acceso remoto
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, s->win);
+}
+
+// Publica key (>= 0). Devuelve 1 si nadie había publicado antes.
+static inline int des_stop_post(des_stop_t *s, long key) {
+    long previous;
+
+    MPI_Fetch_and_op(&key, &previous, MPI_LONG, 0, 0, MPI_MIN, s->win);
+    MPI_Win_flush(0, s->win);
+    s->seen = (previous < key) ? previous : key;
+    return previous == DES_STOP_EMPTY;
+}
+
+// Vuelve a leer la bandera aunque ya se haya visto un valor, para quien necesita el mínimo
+// actual y no solo saber que alguien publicó (el cerco de bf_a2). Devuelve lo mismo que check.
+static inline int des_stop_refresh(des_stop_t *s, long *key) {
+    long value;
+
+    MPI_Fetch_and_op(NULL, &value, MPI_LONG, 0, 0, MPI_NO_OP, s->win);
+    MPI_Win_flush(0, s->win);
+    if (value != DES_STOP_EMPTY) s->seen = value;
+    if (key) *key = s->seen;
+    return s->seen != DES_STOP_NONE;
+}
+
+// Devuelve 1 (y la clave en *key, si no es NULL) si alguien ya publicó. El primer valor
+// visto queda fijo: basta para parar.
+static inline int des_stop_check(des_stop_t *s, long *key) {
+    if (s->seen == DES_STOP_NONE) return des_stop_refresh(s, key);
+    if (key) *key = s->seen;
+    return 1;
+}
+
+// Colectiva. Tras ella todos ven el valor definitivo (DES_STOP_NONE si nadie publicó).
+static inline long des_stop_finish(des_stop_t *s) {
+    long key;
+
+    MPI_Barrier(s->comm);   // todos los post ya terminaron (hacen flush antes de volver)
+    s->seen = DES_STOP_NONE;
+    des_stop_check(s, &key);
+    MPI_Win_unlock_all(s->win);
+    MPI_Win_free(&s->win);
+    return key;
+}
+
+#endif
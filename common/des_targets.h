@@ -0,0 +1,329 @@
+#ifndef DES_TARGETS_H
+#define DES_TARGETS_H
+
+// Varios textos cifrados en un solo barrido (-t). Cada lote de claves se carga una vez y se
+// prueba contra todos los objetivos pendientes:
+//   - con texto conocido de 8 bytes o más (-p) se cifra el primer bloque del prefijo una vez
+//     por clave y el resultado se busca en una tabla con el primer bloque cifrado de cada
+//     objetivo: el coste no depende del número de objetivos;
+//   - con la frase por bloques (-x) se cifran sus fragmentos y se buscan en una tabla con
+//     los bloques de todos los objetivos (des_cribset.h);
+//   - si no, se descifra el primer bloque de cada objetivo pendiente (un cifrado por
+//     objetivo, pero la carga de claves y el recorrido se comparten).
+// Un objetivo es "archivo[:clave]" (texto en claro que se cifra en el proceso 0, como -f) o
+// el texto cifrado en hexadecimal, como el de -d.
+// Los objetivos resueltos se publican como la bandera de des_stop.h: una ventana RMA con un
+// long por objetivo en el proceso 0 (MPI_MIN), que los demás leen al revisar.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <mpi.h>
+#include <openssl/des.h>
+#include "des_keys.h"
+#include "des_bs.h"
+#include "des_prefix.h"
+#include "des_verify.h"
+#include "des_cribset.h"
+#include "des_stop.h"
+
+#define DES_TARGETS_MAX 64
+
+enum { DES_TARGETS_TEXT, DES_TARGETS_PREFIX, DES_TARGETS_BLOCKS };
+
+typedef struct {
+    int n;
+    int pending;                          // objetivos sin resolver
+    int filter;                           // DES_TARGETS_*
+    int text;                             // con DES_TARGETS_TEXT: descartar por texto
+    int len[DES_TARGETS_MAX];
+    long key[DES_TARGETS_MAX];            // clave encontrada, -1 = pendiente
+    char name[DES_TARGETS_MAX][64];
+    unsigned char *ciph[DES_TARGETS_MAX];
+    des_blocktab_t first;                 // primer bloque cifrado -> objetivo (filtro -p)
+    MPI_Win win;                          // clave de cada objetivo en el proceso 0 (des_targets_open)
+    long *slot;                           // memoria de la ventana (vacía fuera del proceso 0)
+    MPI_Comm comm;
+} des_targets_t;
+
+static inline void des_targets_init(des_targets_t *ts) {
+    memset(ts, 0, sizeof(*ts));
+}
+
+static inline void des_targets_encrypt(long key, unsigned char *buf, int len) {
+    DES_cblock keyblock;
+    DES_key_schedule schedule;
+
+    des_key_to_block(key, &keyblock);
+    DES_set_key_unchecked(&keyblock, &schedule);
+    for (int i = 0; i < len; i += 8) {
+        DES_ecb_encrypt((DES_cblock *)(buf + i), (DES_cblock *)(buf + i), &schedule, DES_ENCRYPT);
+    }
+}
+
+// Añade un objetivo (solo en el proceso 0). default_key cifra los archivos sin ":clave".
+// Devuelve 0 y deja un mensaje en stderr si el argumento no es válido.
+static inline int des_targets_add(des_targets_t *ts, const char *arg, long default_key, int max_len) {
+    char path[256];
+    long key = default_key;
+    unsigned char *buf;
+    int len;
+    FILE *f;
+
+    if (ts->n == DES_TARGETS_MAX) {
+        fprintf(stderr, "Error: como máximo %d objetivos\n", DES_TARGETS_MAX);
+        return 0;
+    }
+    buf = malloc(max_len + 8);
+    if (!buf) return 0;
+
+    strncpy(path, arg, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    f = fopen(path, "rb");
+    if (!f) {
+        char *colon = strrchr(path, ':');
+        if (colon) {
+            *colon = '\0';
+            key = atol(colon + 1);
+            f = fopen(path, "rb");
+            if (f && (key <= 0 || !des_key_valid(key))) {
+                fprintf(stderr, "Error: clave inválida en el objetivo %s\n", arg);
+                fclose(f);
+                free(buf);
+                return 0;
+            }
+        }
+    }
+
+    int from_file = (f != NULL);
+    if (from_file) {
+        len = fread(buf, 1, max_len, f);
+        fclose(f);
+        if (len % 8 != 0) {
+            memset(buf + len, 0, 8 - len % 8);
+            len += 8 - len % 8;
+        }
+        des_targets_encrypt(key, buf, len);
+    } else {
+        int n = strlen(arg);
+        if (n == 0 || n % 16 != 0 || n / 2 > max_len) {
+            fprintf(stderr, "Error: %s no es un archivo ni un texto cifrado en hexadecimal "
+                            "(múltiplo de 8 bytes)\n", arg);
+            free(buf);
+            return 0;
+        }
+        for (int i = 0; i < n; i++) {
+            if (!isxdigit((unsigned char)arg[i])) {
+                fprintf(stderr, "Error: %s no es un archivo ni hexadecimal válido\n", arg);
+                free(buf);
+                return 0;
+            }
+        }
+        for (int i = 0; i < n / 2; i++) {
+            char byte[3] = { arg[2 * i], arg[2 * i + 1], 0 };
+            buf[i] = (unsigned char)strtoul(byte, NULL, 16);
+        }
+        len = n / 2;
+    }
+
+    int t = ts->n++;
+    ts->ciph[t] = buf;
+    ts->len[t] = len;
+    ts->key[t] = -1;
+    snprintf(ts->name[t], sizeof(ts->name[t]), "%.63s", from_file ? path : arg);
+    ts->pending = ts->n;
+    return 1;
+}
+
+// Difunde los objetivos del proceso root al resto
+static inline void des_targets_bcast(des_targets_t *ts, int root, MPI_Comm comm) {
+    int id;
+
+    MPI_Comm_rank(comm, &id);
+    MPI_Bcast(&ts->n, 1, MPI_INT, root, comm);
+    MPI_Bcast(ts->len, ts->n, MPI_INT, root, comm);
+    MPI_Bcast(ts->name, sizeof(ts->name[0]) * ts->n, MPI_CHAR, root, comm);
+    for (int t = 0; t < ts->n; t++) {
+        if (id != root) {
+            ts->ciph[t] = malloc(ts->len[t] + 8);
+            if (!ts->ciph[t]) MPI_Abort(comm, 1);
+            ts->key[t] = -1;
+        }
+        MPI_Bcast(ts->ciph[t], ts->len[t], MPI_UNSIGNED_CHAR, root, comm);
+    }
+    ts->pending = ts->n;
+}
+
+// Elige el filtro y prepara las tablas. cs (puede ser NULL) ya tiene los fragmentos de la
+// frase (-x); aquí se le añaden los bloques de cada objetivo. Devuelve 0 sin memoria.
+static inline int des_targets_index(des_targets_t *ts, const des_prefix_t *prefix,
+                                    des_cribset_t *cs) {
+    if (cs && cs->nchunks > 0) {
+        ts->filter = DES_TARGETS_BLOCKS;
+        for (int t = 0; t < ts->n; t++) des_cribset_add(cs, ts->ciph[t], ts->len[t], t);
+    } else if (prefix->len >= 8) {
+        ts->filter = DES_TARGETS_PREFIX;
+        if (!des_blocktab_init(&ts->first, ts->n)) return 0;
+        for (int t = 0; t < ts->n; t++) des_blocktab_add(&ts->first, des_block_load(ts->ciph[t]), t);
+    } else {
+        ts->filter = DES_TARGETS_TEXT;
+    }
+    return 1;
+}
+
+// Capacidad que necesita el cribset de -x para todos los objetivos
+static inline int des_targets_blocks(const des_targets_t *ts) {
+    int blocks = 0;
+    for (int t = 0; t < ts->n; t++) blocks += ts->len[t] / 8;
+    return blocks;
+}
+
+// Confirma la clave sobre el mensaje completo del objetivo t
+static inline int des_targets_verify(const des_targets_t *ts, int t, long key,
+                                     const des_prefix_t *prefix, const des_crib_t *crib,
+                                     unsigned char *buffer) {
+    des_sp_key ks;
+    int len = ts->len[t];
+
+    des_sp_set_key(&ks, key);
+    if (ts->filter == DES_TARGETS_TEXT && prefix->len == 0 && ts->text) {
+        return des_verify(&ks, ts->ciph[t], len, crib, buffer);
+    }
+    des_sp_decrypt_all(&ks, ts->ciph[t], len, buffer);
+    return des_prefix_check(prefix, buffer, len) && des_crib_search(crib, buffer, len);
+}
+
+// Marca el objetivo t como resuelto; devuelve 0 si ya lo estaba
+static inline int des_targets_solve(des_targets_t *ts, int t, long key) {
+    if (t < 0 || t >= ts->n || ts->key[t] != -1) return 0;
+    ts->key[t] = key;
+    ts->pending--;
+    return 1;
+}
+
+static inline int des_targets_check(des_targets_t *ts, int t, long key,
+                                    const des_prefix_t *prefix, const des_crib_t *crib,
+                                    unsigned char *buffer, int *solved, int num_solved) {
+    if (ts->key[t] == -1 && des_targets_verify(ts, t, key, prefix, crib, buffer)) {
+        des_targets_solve(ts, t, key);
+        solved[num_solved++] = t;
+    }
+    return num_solved;
+}
+
+// Prueba el lote [base, base+count) contra todos los objetivos pendientes. Los objetivos
+// resueltos en este lote quedan en solved (como mucho DES_TARGETS_MAX); devuelve cuántos.
+static inline int des_targets_scan(des_targets_t *ts, des_bs_keys *ks, long base, int count,
+                                   const des_prefix_t *prefix, const des_cribset_t *cs,
+                                   const des_crib_t *crib, unsigned char *buffer, int *solved) {
+    int num_solved = 0;
+
+    // Sin filtro ninguno (texto sin ts->text ni prefijo) no se usan las claves traspuestas
+    if (ts->filter != DES_TARGETS_TEXT || prefix->len > 0 || ts->text) {
+        des_bs_keys_load(ks, base, count);
+    }
+
+    if (ts->filter != DES_TARGETS_TEXT) {
+        uint64_t values[DES_BS_LANES];
+        const des_blocktab_t *tab = (ts->filter == DES_TARGETS_BLOCKS) ? &cs->blocks : &ts->first;
+        int rounds = (ts->filter == DES_TARGETS_BLOCKS) ? cs->nchunks : 1;
+
+        for (int c = 0; c < rounds; c++) {
+            des_bs_crypt_lanes(ks, (ts->filter == DES_TARGETS_BLOCKS) ? cs->chunk[c] : prefix->block,
+                               1, values);
+            for (int lane = 0; lane < count; lane++) {
+                for (long s = des_blocktab_find(tab, values[lane], -1); s >= 0;
+                     s = des_blocktab_find(tab, values[lane], s)) {
+                    num_solved = des_targets_check(ts, tab->owner[s], base + lane, prefix, crib,
+                                                   buffer, solved, num_solved);
+                }
+            }
+        }
+        return num_solved;
+    }
+
+    for (int t = 0; t < ts->n; t++) {
+        uint64_t matches[1][DES_BS_LANES / 64];
+        int any;
+
+        if (ts->key[t] != -1) continue;
+        if (prefix->len > 0) {
+            any = des_bs_match(ks, count, ts->ciph[t], 0, &prefix->block, 1, prefix->care, matches);
+        } else {
+            any = ts->text ? des_bs_candidates(ks, count, ts->ciph[t], matches[0])
+                           : des_bs_all(count, matches[0]);
+        }
+        if (!any) continue;
+
+        for (int w = 0; w < des_bs_lanes() / 64; w++) {
+            while (matches[0][w] && ts->key[t] == -1) {
+                long key = base + 64 * w + __builtin_ctzll(matches[0][w]);
+                matches[0][w] &= matches[0][w] - 1;
+                num_solved = des_targets_check(ts, t, key, prefix, crib, buffer, solved, num_solved);
+            }
+        }
+    }
+    return num_solved;
+}
+
+// Colectiva. Abre la ventana con un long por objetivo (DES_STOP_EMPTY = sin resolver).
+static inline void des_targets_open(des_targets_t *ts, MPI_Comm comm) {
+    int id;
+
+    MPI_Comm_rank(comm, &id);
+    ts->comm = comm;
+    MPI_Win_allocate(id == 0 ? ts->n * sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, comm,
+                     &ts->slot, &ts->win);
+    if (id == 0) {
+        for (int t = 0; t < ts->n; t++) ts->slot[t] = DES_STOP_EMPTY;
+    }
+    MPI_Barrier(comm);   // las entradas quedan inicializadas antes de cualquier acceso remoto
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, ts->win);
+}
+
+// Publica que el objetivo t está resuelto con ts->key[t] (un MPI_Fetch_and_op, sin esperar
+// a nadie)
+static inline void des_targets_notify(const des_targets_t *ts, int t) {
+    long previous;
+
+    MPI_Fetch_and_op(&ts->key[t], &previous, MPI_LONG, 0, t, MPI_MIN, ts->win);
+    MPI_Win_flush(0, ts->win);
+}
+
+// Lee todas las entradas de una vez y aplica las de otros procesos. Devuelve cuántos
+// objetivos se resolvieron.
+static inline int des_targets_poll(des_targets_t *ts) {
+    long value[DES_TARGETS_MAX];
+    int solved = 0;
+
+    MPI_Get_accumulate(NULL, 0, MPI_LONG, value, ts->n, MPI_LONG, 0, 0, ts->n, MPI_LONG,
+                       MPI_NO_OP, ts->win);
+    MPI_Win_flush(0, ts->win);
+    for (int t = 0; t < ts->n; t++) {
+        if (value[t] != DES_STOP_EMPTY) solved += des_targets_solve(ts, t, value[t]);
+    }
+    return solved;
+}
+
+// Colectiva. Cierra la ventana y deja en todos los procesos las mismas claves (la menor
+// publicada para cada objetivo).
+static inline void des_targets_finish(des_targets_t *ts) {
+    MPI_Barrier(ts->comm);   // todos los notify ya terminaron (hacen flush antes de volver)
+    for (int t = 0; t < ts->n; t++) ts->key[t] = -1;
+    des_targets_poll(ts);
+    MPI_Win_unlock_all(ts->win);
+    MPI_Win_free(&ts->win);
+
+    ts->pending = 0;
+    for (int t = 0; t < ts->n; t++) {
+        if (ts->key[t] == -1) ts->pending++;
+    }
+}
+
+static inline void des_targets_free(des_targets_t *ts) {
+    for (int t = 0; t < ts->n; t++) free(ts->ciph[t]);
+    if (ts->filter == DES_TARGETS_PREFIX) des_blocktab_free(&ts->first);
+}
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef DES_VERIFY_H
+#define DES_VERIFY_H
+
+// Verificación escalonada de una clave candidata: descifra bloque a bloque, descarta en el
+// primer bloque que no sea texto y busca la palabra de forma incremental (KMP) a medida
+// que avanza, sin copiar el mensaje completo ni llamar a strstr al final.
+//
+// Un bloque es texto si no tiene bytes de control: 0x00-0x1F salvo \t \n \r, ni 0x7F.
+// Los bytes >= 0x80 se aceptan (UTF-8). El último bloque no se filtra porque puede
+// llevar relleno.
+//
+// Además de la versión general hay núcleos generados con macros para 1, 2, 4, 8, 16 y 32
+// bloques y frases de hasta 8 o 16 bytes: el bucle de bloques tiene longitud constante (el
+// compilador lo desenrolla) y la frase se compara con una o dos palabras de 64 bits con
+// máscara en cada posición. des_verify_select() elige el núcleo una vez al arrancar.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "des_sp.h"
+
+#define DES_CRIB_MAX 256
+
+// Palabra a buscar con su tabla de fallos de KMP
+typedef struct {
+    unsigned char word[DES_CRIB_MAX];
+    int len;
+    int fail[DES_CRIB_MAX];
+    int words;            // palabras de 64 bits que ocupa (1 o 2), 0 si es más larga
+    uint64_t cw[2];       // la frase en big-endian, rellena con ceros
+    uint64_t cm[2];       // máscara de los bytes válidos de cada palabra
+} des_crib_t;
+
+// 8 bytes en big-endian
+static inline uint64_t des_load_be(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return __builtin_bswap64(v);
+}
+
+static inline void des_crib_init(des_crib_t *c, const char *word) {
+    int n = strlen(word);
+    if (n > DES_CRIB_MAX) n = DES_CRIB_MAX;
+    memcpy(c->word, word, n);
+    c->len = n;
+    c->words = (n == 0 || n > 16) ? 0 : (n + 7) / 8;
+    for (int w = 0; w < 2; w++) {
+        c->cw[w] = c->cm[w] = 0;
+        for (int i = 0; i < 8; i++) {
+            if (8 * w + i < n) {
+                c->cw[w] |= (uint64_t)c->word[8 * w + i] << (56 - 8 * i);
+                c->cm[w] |= 0xFFULL << (56 - 8 * i);
+            }
+        }
+    }
+    if (n == 0) return;
+
+    c->fail[0] = 0;
+    for (int i = 1, k = 0; i < n; i++) {
+        while (k > 0 && c->word[i] != c->word[k]) k = c->fail[k - 1];
+        if (c->word[i] == c->word[k]) k++;
+        c->fail[i] = k;
+    }
+}
+
+// Avanza el estado de KMP con n bytes; devuelve 1 si la palabra termina dentro de ellos
+static inline int des_crib_feed(const des_crib_t *c, int *state, const unsigned char *p, int n) {
+    int k = *state;
+    for (int i = 0; i < n; i++) {
+        while (k > 0 && p[i] != c->word[k]) k = c->fail[k - 1];
+        if (p[i] == c->word[k]) k++;
+        if (k == c->len) {
+            *state = k;
+            return 1;
+        }
+    }
+    *state = k;
+    return 0;
+}
+
+// Busca la palabra en un texto ya descifrado (palabra vacía = siempre se encuentra)
+static inline int des_crib_search(const des_crib_t *c, const unsigned char *p, int n) {
+    int state = 0;
+    return c->len == 0 || des_crib_feed(c, &state, p, n);
+}
+
+// 1 si los 8 bytes de v son texto (SWAR: un bit por byte, sin acarreos entre bytes)
+static inline int des_text_block(uint64_t v) {
+    const uint64_t L = 0x0101010101010101ULL, H = 0x8080808080808080ULL, M = ~H;
+    uint64_t x;
+
+    uint64_t low = ~((v | H) - 0x20 * L) & ~v & H;       // byte < 0x20
+    x = v ^ (0x7F * L);
+    uint64_t del = ~(((x & M) + M) | x) & H;              // byte == 0x7F
+    x = v ^ (0x09 * L);
+    uint64_t tab = ~(((x & M) + M) | x) & H;
+    x = v ^ (0x0A * L);
+    uint64_t nl = ~(((x & M) + M) | x) & H;
+    x = v ^ (0x0D * L);
+    uint64_t cr = ~(((x & M) + M) | x) & H;
+
+    return ((low & ~(tab | nl | cr)) | del) == 0;
+}
+
+// Versión general: descifra ciph (len múltiplo de 8) con las subclaves ks en out, bloque a
+// bloque (DES escalar de des_sp.h). Devuelve 1 en cuanto aparece la palabra y 0 al primer bloque que no
+// es texto o al llegar al final. out debe tener len + 1 bytes; queda terminado en 0 si se
+// encontró la palabra.
+static inline int des_verify_generic(const des_sp_key *ks, const unsigned char *ciph, int len,
+                             const des_crib_t *crib, unsigned char *out) {
+    int state = 0;
+
+    for (int i = 0; i < len; i += 8) {
+        uint64_t block;
+
+        des_sp_block(ks, ciph + i, out + i, 1);
+        memcpy(&block, out + i, 8);
+        if (i + 8 < len && !des_text_block(block)) return 0;
+        if (crib->len == 0 || des_crib_feed(crib, &state, out + i, 8)) {
+            out[i + 8] = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+typedef int (*des_verify_fn)(const des_sp_key *ks, const unsigned char *ciph, int len,
+                             const des_crib_t *crib, unsigned char *out);
+
+// 8 bytes desde p[i] sin leer más allá de p[n-1] (por encima de n quedan ceros)
+static inline uint64_t des_load_be_at(const unsigned char *p, int n, int i) {
+    return (i + 8 <= n) ? des_load_be(p + i) : des_load_be(p + n - 8) << (8 * (i + 8 - n));
+}
+
+// Busca una frase de words (1 o 2, constante en cada núcleo) palabras con comparaciones
+// de 64 bits con máscara
+static inline __attribute__((always_inline)) int des_crib_words(const des_crib_t *c, int words,
+                                                                const unsigned char *p, int n) {
+    for (int i = 0; i + c->len <= n; i++) {
+        if (((des_load_be_at(p, n, i) ^ c->cw[0]) & c->cm[0]) != 0) continue;
+        if (words == 1 || ((des_load_be_at(p, n, i + 8) ^ c->cw[1]) & c->cm[1]) == 0) return 1;
+    }
+    return 0;
+}
+
+// Busca la frase en los n primeros bytes con W palabras (0 = KMP); la frase vacía se
+// encuentra si hay al menos un bloque
+#define DES_VERIFY_FIND(W, n)                                                             \
+    (crib->len == 0 ? (n) > 0                                                             \
+     : (W) ? des_crib_words(crib, (W), out, (n)) : des_crib_search(crib, out, (n)))
+
+// Núcleo para NB bloques y frases de W palabras. Los bloques se descifran de DES_SP_WAYS en
+// DES_SP_WAYS intercalados (en ECB son independientes), así que descartar en el segundo
+// bloque cuesta casi lo mismo que en el primero. Mismo resultado que la versión general: si
+// un bloque intermedio no es texto, la clave vale solo si la frase ya terminó antes de él.
+#define DES_VERIFY_GROUP(NB) ((NB) < DES_SP_WAYS ? (NB) : DES_SP_WAYS)
+#define DES_VERIFY_KERNEL(NB, W)                                                          \
+static int des_verify_##NB##_##W(const des_sp_key *ks, const unsigned char *ciph, int len, \
+                                 const des_crib_t *crib, unsigned char *out) {            \
+    const des_sp_key *kp[DES_SP_WAYS];                                                    \
+    (void)len;                                                                            \
+    for (int j = 0; j < DES_SP_WAYS; j++) kp[j] = ks;                                     \
+    _Pragma("GCC unroll 8")                                                               \
+    for (int g = 0; g < (NB); g += DES_VERIFY_GROUP(NB)) {                                \
+        uint64_t state[DES_SP_WAYS];                                                      \
+        for (int j = 0; j < DES_VERIFY_GROUP(NB); j++) {                                  \
+            state[j] = des_sp_ip(ciph + 8 * (g + j));                                     \
+        }                                                                                 \
+        des_sp_crypt(kp, DES_VERIFY_GROUP(NB), state, 1);                                 \
+        for (int j = 0; j < DES_VERIFY_GROUP(NB); j++) {                                  \
+            int i = g + j;                                                                \
+            des_sp_fp(state[j], out + 8 * i);                                             \
+            if (i + 1 < (NB) && !des_text_block(des_load_be(out + 8 * i))) {              \
+                return DES_VERIFY_FIND(W, 8 * i);                                         \
+            }                                                                             \
+        }                                                                                 \
+    }                                                                                     \
+    out[8 * (NB)] = 0;                                                                    \
+    return DES_VERIFY_FIND(W, 8 * (NB));                                                  \
+}
+
+#define DES_VERIFY_KERNELS(NB) \
+    DES_VERIFY_KERNEL(NB, 0) DES_VERIFY_KERNEL(NB, 1) DES_VERIFY_KERNEL(NB, 2)
+
+DES_VERIFY_KERNELS(1)
+DES_VERIFY_KERNELS(2)
+DES_VERIFY_KERNELS(4)
+DES_VERIFY_KERNELS(8)
+DES_VERIFY_KERNELS(16)
+DES_VERIFY_KERNELS(32)
+
+#define DES_VERIFY_ENTRY(NB) { NB, { des_verify_##NB##_0, des_verify_##NB##_1, des_verify_##NB##_2 } }
+
+static const struct {
+    int blocks;
+    des_verify_fn fn[3];
+} des_verify_kernels[] = {
+    DES_VERIFY_ENTRY(1), DES_VERIFY_ENTRY(2), DES_VERIFY_ENTRY(4),
+    DES_VERIFY_ENTRY(8), DES_VERIFY_ENTRY(16), DES_VERIFY_ENTRY(32)
+};
+
+// Núcleo para un mensaje de len bytes y esa frase (la versión general si no hay uno
+// especializado para ese número de bloques)
+static inline des_verify_fn des_verify_select(int len, const des_crib_t *crib) {
+    for (unsigned i = 0; i < sizeof(des_verify_kernels) / sizeof(des_verify_kernels[0]); i++) {
+        if (des_verify_kernels[i].blocks * 8 == len) return des_verify_kernels[i].fn[crib->words];
+    }
+    return des_verify_generic;
+}
+
+// Descripción del núcleo elegido, para los mensajes de arranque
+static inline void des_verify_describe(char *buf, int size, int len, const des_crib_t *crib) {
+    if (des_verify_select(len, crib) == des_verify_generic) {
+        snprintf(buf, size, "general (%d bloques)", len / 8);
+    } else if (crib->words > 0) {
+        snprintf(buf, size, "%d bloques, frase en %d palabra%s de 64 bits", len / 8, crib->words,
+                 crib->words > 1 ? "s" : "");
+    } else {
+        snprintf(buf, size, "%d bloques, frase con KMP", len / 8);
+    }
+}
+
+// Para mensajes de longitud variable (p. ej. varios objetivos): elige el núcleo en cada
+// llamada
+static inline int des_verify(const des_sp_key *ks, const unsigned char *ciph, int len,
+                             const des_crib_t *crib, unsigned char *out) {
+    return des_verify_select(len, crib)(ks, ciph, len, crib, out);
+}
+
+// Versión CBC de la verificación general: Pi = D(Ci) ^ C(i-1), con C(-1) = iv. Mismo
+// descarte bloque a bloque; solo se usa con los supervivientes del filtro del primer bloque.
+static inline int des_verify_cbc(const des_sp_key *ks, const unsigned char *ciph, int len,
+                                 const unsigned char *iv, const des_crib_t *crib,
+                                 unsigned char *out) {
+    int state = 0;
+
+    for (int i = 0; i < len; i += 8) {
+        const unsigned char *prev = i ? ciph + i - 8 : iv;
+        uint64_t block;
+
+        des_sp_block(ks, ciph + i, out + i, 1);
+        for (int b = 0; b < 8; b++) out[i + b] ^= prev[b];
+        memcpy(&block, out + i, 8);
+        if (i + 8 < len && !des_text_block(block)) return 0;
+        if (crib->len == 0 || des_crib_feed(crib, &state, out + i, 8)) {
+            out[i + 8] = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Descifra el mensaje completo con ks (len + 1 bytes en out, terminado en 0)
+static inline void des_sp_decrypt_all(const des_sp_key *ks, const unsigned char *ciph, int len,
+                                      unsigned char *out) {
+    for (int i = 0; i < len; i += 8) des_sp_block(ks, ciph + i, out + i, 1);
+    out[len] = 0;
+}
+
+// Igual en CBC (iv = NULL equivale a ECB)
+static inline void des_sp_decrypt_cbc(const des_sp_key *ks, const unsigned char *ciph, int len,
+                                      const unsigned char *iv, unsigned char *out) {
+    des_sp_decrypt_all(ks, ciph, len, out);
+    if (!iv) return;
+    for (int i = len - 8; i >= 0; i -= 8) {
+        const unsigned char *prev = i ? ciph + i - 8 : iv;
+        for (int b = 0; b < 8; b++) out[i + b] ^= prev[b];
+    }
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef DES_WORDLIST_H
+#define DES_WORDLIST_H
+
+// Ataque de diccionario (--wordlist): claves derivadas de frases en vez de un rango.
+//
+// Lectura: cada proceso lee con MPI-IO su parte del archivo ([start, stop) en bytes; le tocan
+// las líneas que empiezan ahí) en bloques de DES_WORDLIST_BLOCK. Hay dos búferes: mientras
+// se derivan y prueban las palabras de uno, el siguiente bloque llega con MPI_File_iread_at,
+// así que la lectura se solapa con el kernel y una lista de varios GB no va al ritmo de fgets.
+// Cada búfer reserva DES_WORDLIST_LINE bytes delante de los datos para pegar el trozo de
+// línea que quedó al final del bloque anterior.
+//
+// Reglas (--rules): una letra por variante de cada palabra, al estilo de los crackers de
+// contraseñas: ':' tal cual, 'l' minúsculas, 'u' mayúsculas, 'c' primera en mayúscula,
+// 'r' al revés, 'y' duplicada, 'd' con un dígito al final (10 variantes).
+//
+// Derivación (--derive): DES_string_to_key de OpenSSL ("str"), los primeros 8 caracteres
+// copiados al bloque de clave, rellenos con ceros ("pack"), o las dos ("both").
+
+#include <string.h>
+#include <ctype.h>
+#include <mpi.h>
+#include <openssl/des.h>
+#include "des_keys.h"
+
+#define DES_WORDLIST_BLOCK (4L << 20)   // bytes por lectura
+#define DES_WORDLIST_LINE 256           // palabras más largas se descartan
+#define DES_WORDLIST_RULES ":lucryd"
+#define DES_WORDLIST_VARIANTS 64        // variantes por palabra como máximo
+
+#define DES_DERIVE_STRING 1
+#define DES_DERIVE_PACK 2
+
+typedef struct {
+    MPI_File fh;
+    MPI_Offset size;
+    MPI_Offset start, stop;    // líneas de este proceso: las que empiezan en [start, stop)
+    MPI_Offset next_read;      // posición de la próxima lectura
+    char *buf[2];
+    int cur;                   // búfer que se está analizando
+    MPI_Request req;
+    int pending;               // hay una lectura en curso sobre buf[!cur]
+    long pending_len;
+    char *data;                // datos de buf[cur], empezando por el resto de la línea anterior
+    long len, off;
+    MPI_Offset data_pos;       // posición en el archivo de data[0]
+    int skip;                  // descartar hasta el próximo salto de línea
+    unsigned long words;
+} des_wordlist_t;
+
+static inline void des_wordlist_read(des_wordlist_t *w) {
+    long count = DES_WORDLIST_BLOCK;
+
+    if (w->next_read >= w->size) return;
+    if (count > w->size - w->next_read) count = w->size - w->next_read;
+    MPI_File_iread_at(w->fh, w->next_read, w->buf[!w->cur] + DES_WORDLIST_LINE, (int)count,
+                      MPI_BYTE, &w->req);
+    w->pending = 1;
+    w->pending_len = count;
+    w->next_read += count;
+}
+
+// Colectiva. Devuelve 0 si no se puede abrir el archivo.
+static inline int des_wordlist_open(des_wordlist_t *w, const char *path, MPI_Comm comm) {
+    int id, N;
+
+    memset(w, 0, sizeof(*w));
+    MPI_Comm_rank(comm, &id);
+    MPI_Comm_size(comm, &N);
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &w->fh) != MPI_SUCCESS) return 0;
+    MPI_File_get_size(w->fh, &w->size);
+
+    w->buf[0] = malloc(DES_WORDLIST_LINE + DES_WORDLIST_BLOCK);
+    w->buf[1] = malloc(DES_WORDLIST_LINE + DES_WORDLIST_BLOCK);
+    if (!w->buf[0] || !w->buf[1]) return 0;
+
+    w->start = w->size / N * id;
+    w->stop = (id == N - 1) ? w->size : w->size / N * (id + 1);
+    // Desde el byte anterior: lo que haya hasta el primer salto es del proceso anterior
+    w->next_read = w->start > 0 ? w->start - 1 : 0;
+    w->skip = w->start > 0;
+    w->data_pos = w->next_read;
+    w->cur = 1;
+    w->data = w->buf[1] + DES_WORDLIST_LINE;
+    des_wordlist_read(w);
+    return 1;
+}
+
+// Pasa al bloque siguiente con el resto de línea delante. Devuelve 0 si no hay más datos.
+static inline int des_wordlist_advance(des_wordlist_t *w) {
+    long tail = w->len - w->off;
+    MPI_Status st;
+
+    if (!w->pending) return 0;
+    MPI_Wait(&w->req, &st);
+    w->pending = 0;
+    if (tail > DES_WORDLIST_LINE) {
+        w->skip = 1;
+        tail = 0;
+    }
+    char *next = w->buf[!w->cur] + DES_WORDLIST_LINE;
+    memcpy(next - tail, w->data + w->off, tail);
+    w->data_pos += w->len - tail;
+    w->cur = !w->cur;
+    w->data = next - tail;
+    w->len = tail + w->pending_len;
+    w->off = 0;
+    des_wordlist_read(w);
+    return 1;
+}
+
+// Siguiente palabra de este proceso (sin salto de línea). Devuelve 0 al terminar su parte.
+static inline int des_wordlist_next(des_wordlist_t *w, char **word, int *len) {
+    while (1) {
+        if (!w->skip && w->data_pos + w->off >= w->stop) return 0;
+
+        char *line = w->data + w->off;
+        char *nl = memchr(line, '\n', w->len - w->off);
+        long n;
+        if (nl) {
+            n = nl - line;
+            w->off += n + 1;
+        } else if (!w->pending && w->next_read >= w->size && w->off < w->len) {
+            n = w->len - w->off;   // última línea sin salto
+            w->off = w->len;
+        } else {
+            if (!des_wordlist_advance(w)) return 0;
+            continue;
+        }
+
+        if (w->skip) {
+            w->skip = 0;
+            continue;
+        }
+        if (n > 0 && line[n - 1] == '\r') n--;
+        if (n == 0 || n >= DES_WORDLIST_LINE) continue;
+        *word = line;
+        *len = (int)n;
+        w->words++;
+        return 1;
+    }
+}
+
+// Colectiva
+static inline void des_wordlist_close(des_wordlist_t *w) {
+    if (w->pending) MPI_Wait(&w->req, MPI_STATUS_IGNORE);
+    MPI_File_close(&w->fh);
+    free(w->buf[0]);
+    free(w->buf[1]);
+}
+
+static inline int des_wordlist_rules_valid(const char *rules) {
+    return rules[0] != '\0' && strspn(rules, DES_WORDLIST_RULES) == strlen(rules);
+}
+
+// Variantes de una palabra según las reglas: out[i] de largo lens[i]. Devuelve cuántas.
+static inline int des_wordlist_mangle(const char *rules, const char *word, int len,
+                                      char out[][2 * DES_WORDLIST_LINE], int *lens) {
+    int n = 0;
+
+    for (const char *r = rules; *r && n < DES_WORDLIST_VARIANTS; r++) {
+        char *o = out[n];
+        int l = len;
+        memcpy(o, word, len);
+        switch (*r) {
+        case 'l': for (int i = 0; i < l; i++) o[i] = tolower((unsigned char)o[i]); break;
+        case 'u': for (int i = 0; i < l; i++) o[i] = toupper((unsigned char)o[i]); break;
+        case 'c':
+            for (int i = 0; i < l; i++) o[i] = tolower((unsigned char)o[i]);
+            o[0] = toupper((unsigned char)o[0]);
+            break;
+        case 'r': for (int i = 0; i < l; i++) o[i] = word[l - 1 - i]; break;
+        case 'y': memcpy(o + l, word, len); l += len; break;
+        case 'd':
+            for (int digit = 0; digit < 10 && n < DES_WORDLIST_VARIANTS; digit++) {
+                memcpy(out[n], word, len);
+                out[n][len] = (char)('0' + digit);
+                lens[n++] = len + 1;
+            }
+            continue;
+        }
+        lens[n++] = l;
+    }
+    return n;
+}
+
+// Claves (índices canónicos) de una variante; devuelve cuántas (1 o 2)
+static inline int des_wordlist_derive(int derive, const char *word, int len, long *keys) {
+    char text[2 * DES_WORDLIST_LINE + 1];
+    DES_cblock block;
+    int n = 0;
+
+    if (derive & DES_DERIVE_STRING) {
+        memcpy(text, word, len);
+        text[len] = '\0';
+        DES_string_to_key(text, &block);
+        keys[n++] = des_key_from_block(&block);
+    }
+    if (derive & DES_DERIVE_PACK) {
+        memset(block, 0, sizeof(block));
+        memcpy(block, word, len < 8 ? len : 8);
+        keys[n++] = des_key_from_block(&block);
+    }
+    return n;
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <openssl/des.h>
 #include <stdint.h>
+#include "common/des_keys.h"
 
 #define MAX_TEXT 256
 
@@ -34,13 +35,8 @@ void des_encrypt(unsigned char* ciphertext, uint64_t key_value, int len) {
     DES_cblock key;
     DES_key_schedule schedule;
     
-    // Convertir key_value a DES_cblock
-    for (int i = 0; i < 8; i++) {
-        key[i] = (key_value >> (56 - i * 8)) & 0xFF;
-    }
-    
-    // Establecer paridad de bits
-    DES_set_odd_parity(&key);
+    // Convertir key_value a DES_cblock (numeración canónica, paridad impar)
+    des_key_to_block((long)key_value, &key);
     
     // Crear el schedule de la clave
     DES_set_key_unchecked(&key, &schedule);
@@ -59,13 +55,8 @@ void des_decrypt(unsigned char* ciphertext, unsigned char* decrypted,
     DES_cblock key;
     DES_key_schedule schedule;
     
-    // Convertir key_value a DES_cblock
-    for (int i = 0; i < 8; i++) {
-        key[i] = (key_value >> (56 - i * 8)) & 0xFF;
-    }
-    
-    // Establecer paridad de bits
-    DES_set_odd_parity(&key);
+    // Convertir key_value a DES_cblock (numeración canónica, paridad impar)
+    des_key_to_block((long)key_value, &key);
     
     // Crear el schedule de la clave
     DES_set_key_unchecked(&key, &schedule);
@@ -177,6 +168,7 @@ void run_normal_execution(unsigned char* buffer, int ciphlen, char* search_word,
         printf("✓ Clave encontrada: ");
         print_key(result.key_found);
         printf(" (decimal: %llu)\n", (unsigned long long)result.key_found);
+        des_key_print_class(stdout, (long)result.key_found);
         
         // Verificar que sea correcta
         unsigned char* verify = (unsigned char*)calloc(ciphlen + 1, 1);
@@ -269,6 +261,7 @@ void run_tests(unsigned char buffer[], int ciphlen, char search_word[]) {
             printf("✓ Clave encontrada: ");
             print_key(result.key_found);
             printf(" (decimal: %llu)\n", (unsigned long long)result.key_found);
+            des_key_print_class(stdout, (long)result.key_found);
             
             // Verificar que sea correcta
             unsigned char* verify = (unsigned char*)calloc(ciphlen + 1, 1);
@@ -342,8 +335,8 @@ int main(int argc, char *argv[]) {
 
         if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) { // Llave de cifrado
             known_key = atol(argv[++i]);
-            if (known_key <= 0) { // Validación de clave válida
-                fprintf(stderr, "Error: La clave debe ser un número positivo\n");
+            if (known_key <= 0 || !des_key_valid(known_key)) { // Validación de clave válida
+                fprintf(stderr, "Error: La clave debe estar entre 1 y %ld\n", DES_KEY_SPACE - 1);
                 break;
             }
         } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) { // Palabras clave a buscar en descifrado
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <mpi.h>
+#include "common/des_stop.h"
+
+// Benchmark del aviso de parada: cuánto tardan TODOS los procesos en enterarse de que uno
+// encontró la clave, según el número de procesos. Compara el método anterior (N-1 MPI_Send
+// más un MPI_Irecv por proceso revisado con MPI_Test) con la bandera RMA de des_stop.h.
+//
+// Para cada tamaño (2, 4, 8, ... y el total) se crea un subcomunicador. Sus procesos simulan
+// la búsqueda en porciones de -s microsegundos y revisan el aviso entre porción y porción; el
+// último proceso "encuentra" la clave a los -d milisegundos. El tiempo de parada de una
+// repetición es el del último proceso en enterarse, medido desde el aviso, y se informa la
+// mediana de -r repeticiones. Los relojes se alinean con una barrera al empezar cada
+// repetición, así que el resultado incluye la desigualdad de salida de esa barrera.
+
+#define METHOD_P2P 0
+#define METHOD_RMA 1
+
+// Trabajo simulado: espera activa de `seconds`
+static void busy(double seconds) {
+    double until = MPI_Wtime() + seconds;
+    while (MPI_Wtime() < until) { }
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Una repetición. Devuelve (en todos los procesos) el tiempo de parada en segundos.
+static double run_once(int method, int rep, double delay, double slice, MPI_Comm comm) {
+    int id, N;
+    long found = -1;
+    double start, fired = 0.0, stopped;
+
+    MPI_Comm_rank(comm, &id);
+    MPI_Comm_size(comm, &N);
+
+    des_stop_t stop;
+    MPI_Request req;
+    if (method == METHOD_RMA) {
+        des_stop_init(&stop, comm);
+    } else {
+        MPI_Irecv(&found, 1, MPI_LONG, MPI_ANY_SOURCE, rep, comm, &req);
+    }
+
+    MPI_Barrier(comm);
+    start = MPI_Wtime();
+
+    while (1) {
+        busy(slice);
+        if (id == N - 1 && MPI_Wtime() - start >= delay) {
+            long key = 123456L;
+            fired = MPI_Wtime() - start;
+            if (method == METHOD_RMA) {
+                des_stop_post(&stop, key);
+            } else {
+                for (int node = 0; node < N; node++) {
+                    if (node != id) MPI_Send(&key, 1, MPI_LONG, node, rep, comm);
+                }
+            }
+            break;
+        }
+        if (method == METHOD_RMA) {
+            if (des_stop_check(&stop, NULL)) break;
+        } else {
+            int flag;
+            MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+            if (flag) break;
+        }
+    }
+    stopped = MPI_Wtime() - start;
+
+    if (method == METHOD_RMA) {
+        des_stop_finish(&stop);
+    } else if (id == N - 1) {
+        MPI_Cancel(&req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+
+    double last;
+    MPI_Allreduce(&stopped, &last, 1, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Bcast(&fired, 1, MPI_DOUBLE, N - 1, comm);
+    return last - fired;
+}
+
+int main(int argc, char *argv[]) {
+    int N, id;
+    int reps = 20;
+    double delay = 0.05;     // -d en milisegundos
+    double slice = 100e-6;   // -s en microsegundos
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &N);
+    MPI_Comm_rank(MPI_COMM_WORLD, &id);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:d:s:")) != -1) {
+        switch (opt) {
+            case 'r': reps = atoi(optarg); break;
+            case 'd': delay = atof(optarg) / 1e3; break;
+            case 's': slice = atof(optarg) / 1e6; break;
+            default:
+                if (id == 0) fprintf(stderr, "Uso: %s [-r repeticiones] [-d ms] [-s us]\n", argv[0]);
+                MPI_Finalize();
+                return 1;
+        }
+    }
+    if (reps < 1 || delay < 0 || slice <= 0) {
+        if (id == 0) fprintf(stderr, "Error: parámetros inválidos\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    double *times = malloc(reps * sizeof(double));
+    if (!times) {
+        perror("malloc");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    if (id == 0) {
+        printf("Tiempo de parada (mediana de %d, aviso a los %.1f ms, revisión cada %.0f us)\n",
+               reps, delay * 1e3, slice * 1e6);
+        printf("%8s %14s %14s\n", "procesos", "send (us)", "rma (us)");
+    }
+
+    for (int size = 2; ; size *= 2) {
+        if (size > N) size = N;
+
+        MPI_Comm sub;
+        MPI_Comm_split(MPI_COMM_WORLD, id < size ? 0 : MPI_UNDEFINED, id, &sub);
+
+        double median[2] = { 0.0, 0.0 };
+        if (sub != MPI_COMM_NULL) {
+            for (int method = METHOD_P2P; method <= METHOD_RMA; method++) {
+                for (int r = 0; r < reps; r++) times[r] = run_once(method, r, delay, slice, sub);
+                qsort(times, reps, sizeof(double), cmp_double);
+                median[method] = times[reps / 2];
+            }
+            MPI_Comm_free(&sub);
+        }
+        if (id == 0) {
+            printf("%8d %14.1f %14.1f\n", size, median[METHOD_P2P] * 1e6, median[METHOD_RMA] * 1e6);
+            fflush(stdout);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (size == N) break;
+    }
+
+    free(times);
+    MPI_Finalize();
+    return 0;
+}